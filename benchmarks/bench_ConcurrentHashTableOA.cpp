@@ -0,0 +1,59 @@
+#include <benchmark/benchmark.h>
+#include "../include/ConcurrentHashTableOA.hpp"
+#include "../include/ShardedHashTableOA.hpp"
+#include <memory>
+#include <random>
+
+// Масштабирование по потокам при 200 чтениях на одну запись: чтение
+// без замков против шардов под shared_mutex. Запись — поровну вставки
+// и удаления по диапазону ключей, таблица заполнена наполовину.
+
+static constexpr int kReadKeyRange = 1 << 20;
+static constexpr int kReadsPerWrite = 200;
+
+template <typename Table>
+static void run_read_mostly(benchmark::State& state,
+                            std::unique_ptr<Table>& shared) {
+    if (state.thread_index() == 0) {
+        shared = std::make_unique<Table>(kReadKeyRange);
+        for (int key = 0; key < kReadKeyRange; key += 2) {
+            shared->insert(key, key);
+        }
+    }
+
+    std::mt19937 rng(state.thread_index() + 1);
+    std::uniform_int_distribution<int> keyDist(0, kReadKeyRange - 1);
+    std::uniform_int_distribution<int> opDist(0, kReadsPerWrite);
+
+    for (auto _ : state) {
+        int key = keyDist(rng);
+        int op = opDist(rng);
+        if (op != 0) {
+            benchmark::DoNotOptimize(shared->find(key));
+        } else if (key & 1) {
+            benchmark::DoNotOptimize(shared->insert(key, key));
+        } else {
+            benchmark::DoNotOptimize(shared->remove(key));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        shared.reset();
+    }
+}
+
+static void BM_LockFreeRead_ReadMostly(benchmark::State& state) {
+    static std::unique_ptr<ConcurrentHashTableOA<int, int>> table;
+    run_read_mostly(state, table);
+}
+
+BENCHMARK(BM_LockFreeRead_ReadMostly)->ThreadRange(1, 64)->UseRealTime();
+
+static void BM_ShardedRead_ReadMostly(benchmark::State& state) {
+    static std::unique_ptr<ShardedHashTableOA<int, int>> table;
+    run_read_mostly(state, table);
+}
+
+BENCHMARK(BM_ShardedRead_ReadMostly)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,71 @@
+#include <benchmark/benchmark.h>
+#include "../include/FixedHashTableOA.hpp"
+#include "../include/HashTableOA.hpp"
+#include <string_view>
+
+// Небольшой статический словарь: FixedHashTableOA собран при
+// компиляции, HashTableOA заполняется при старте.
+
+constexpr std::pair<std::string_view, int> kMethods[] = {
+    {"GET", 1}, {"HEAD", 2}, {"POST", 3}, {"PUT", 4}, {"DELETE", 5},
+    {"CONNECT", 6}, {"OPTIONS", 7}, {"TRACE", 8}, {"PATCH", 9},
+    {"PROPFIND", 10}, {"PROPPATCH", 11}, {"MKCOL", 12}, {"COPY", 13},
+    {"MOVE", 14}, {"LOCK", 15}, {"UNLOCK", 16}};
+
+constexpr FixedHashTableOA<std::string_view, int, 16> kFixedMethods = {
+    {"GET", 1}, {"HEAD", 2}, {"POST", 3}, {"PUT", 4}, {"DELETE", 5},
+    {"CONNECT", 6}, {"OPTIONS", 7}, {"TRACE", 8}, {"PATCH", 9},
+    {"PROPFIND", 10}, {"PROPPATCH", 11}, {"MKCOL", 12}, {"COPY", 13},
+    {"MOVE", 14}, {"LOCK", 15}, {"UNLOCK", 16}};
+
+static void BM_Fixed_Find(benchmark::State& state) {
+    for (auto _ : state) {
+        for (const auto& [name, code] : kMethods) {
+            benchmark::DoNotOptimize(kFixedMethods.find(name));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(kMethods));
+}
+
+BENCHMARK(BM_Fixed_Find);
+
+static void BM_FixedBaseline_Find(benchmark::State& state) {
+    HashTableOA<std::string, int> table(32, HashMode::Fast);
+    for (const auto& [name, code] : kMethods) {
+        table.insert(std::string(name), code);
+    }
+
+    for (auto _ : state) {
+        for (const auto& [name, code] : kMethods) {
+            benchmark::DoNotOptimize(table.find(name));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * std::size(kMethods));
+}
+
+BENCHMARK(BM_FixedBaseline_Find);
+
+// цена старта: построение того же словаря во время выполнения
+static void BM_Fixed_BuildAtRuntime(benchmark::State& state) {
+    for (auto _ : state) {
+        FixedHashTableOA<std::string_view, int, 16> table;
+        for (const auto& [name, code] : kMethods) {
+            table.insert(name, code);
+        }
+        benchmark::DoNotOptimize(table);
+    }
+}
+
+BENCHMARK(BM_Fixed_BuildAtRuntime);
+
+static void BM_FixedBaseline_Build(benchmark::State& state) {
+    for (auto _ : state) {
+        HashTableOA<std::string, int> table(32, HashMode::Fast);
+        for (const auto& [name, code] : kMethods) {
+            table.insert(std::string(name), code);
+        }
+        benchmark::DoNotOptimize(table.getSize());
+    }
+}
+
+BENCHMARK(BM_FixedBaseline_Build);
@@ -1,7 +1,15 @@
 // Copyright
 #include <benchmark/benchmark.h>
+#include <malloc.h>
+#include <unistd.h>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
 #include <random>
+#include <string>
 #include <vector>
+#include "../include/ConcurrentHashTableChains.hpp"
 #include "../include/HashTableChains.hpp"
 
 static std::vector<int> generate_random_ints(size_t n) {
@@ -12,6 +20,19 @@ static std::vector<int> generate_random_ints(size_t n) {
     return v;
 }
 
+// текущий RSS процесса в мегабайтах (Linux); свободная память кучи
+// сначала возвращается системе, чтобы прошлые прогоны не искажали
+// прирост
+static double residentMegabytes() {
+    malloc_trim(0);
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0;
+    size_t resident = 0;
+    statm >> pages >> resident;
+    return static_cast<double>(resident) * sysconf(_SC_PAGESIZE)
+        / (1024.0 * 1024.0);
+}
+
 // HASHTABLE CHAINS
 
 static void BM_HashTableChains_Insert(benchmark::State& state) {
@@ -30,6 +51,184 @@ static void BM_HashTableChains_Insert(benchmark::State& state) {
 }
 BENCHMARK(BM_HashTableChains_Insert)->Arg(1000)->Arg(5000)->Arg(10000)->Arg(50000);
 
+// GROWTH BENCHMARK
+// таблица стартует с ёмкости по умолчанию и растёт до n ключей;
+// время на вставку не должно зависеть от n, а max_insert_ns показывает
+// самую долгую одиночную вставку (корзины переносятся постепенно)
+static void BM_HashTableChains_InsertGrowing(benchmark::State& state) {
+    const size_t n = state.range(0);
+    double maxInsertNs = 0.0;
+
+    for (auto _ : state) {
+        HashTable<int, int> table(5, HashSetup::Fast);
+
+        for (size_t i = 0; i < n; i++) {
+            auto start = std::chrono::steady_clock::now();
+            table.insert(static_cast<int>(i), static_cast<int>(i));
+            auto stop = std::chrono::steady_clock::now();
+
+            double ns = std::chrono::duration<double, std::nano>(
+                stop - start).count();
+            if (ns > maxInsertNs) maxInsertNs = ns;
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["max_insert_ns"] = maxInsertNs;
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_HashTableChains_InsertGrowing)
+    ->Arg(1000)->Arg(100000)->Arg(1000000)->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+
+// поиск после роста до n ключей: цепочки остаются короткими
+static void BM_HashTableChains_FindAfterGrowth(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    HashTable<int, int> table(5, HashSetup::Fast);
+    for (size_t i = 0; i < n; i++) {
+        table.insert(static_cast<int>(i), static_cast<int>(i));
+    }
+    // доводим перенос до конца, чтобы мерить только поиск
+    while (table.isRehashing()) {
+        benchmark::DoNotOptimize(table.isPresent(0));
+    }
+
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(n) - 1);
+    std::vector<int> queries(100000);
+    for (int& key : queries) key = dist(rng);
+
+    for (auto _ : state) {
+        for (int key : queries) {
+            benchmark::DoNotOptimize(table.find(key));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK(BM_HashTableChains_FindAfterGrowth)
+    ->Arg(1000)->Arg(100000)->Arg(1000000)->Arg(10000000);
+
+// поиск в плотно заполненной таблице без роста: range(1) — ключей
+// на корзину; первые пары корзины лежат в ней самой, в цепочку
+// переполнения уходят только лишние
+static void BM_HashTableChains_FindDenseBuckets(benchmark::State& state) {
+    const size_t n = state.range(0);
+    const int perBucket = state.range(1);
+
+    HashTable<int, int> table(static_cast<int>(n / perBucket),
+        HashSetup::Fast);
+    table.setMaxLoadFactor(static_cast<float>(perBucket) + 1.0f);
+    for (size_t i = 0; i < n; i++) {
+        table.insert(static_cast<int>(i), static_cast<int>(i));
+    }
+
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(n) - 1);
+    std::vector<int> queries(100000);
+    for (int& key : queries) key = dist(rng);
+
+    for (auto _ : state) {
+        for (int key : queries) {
+            benchmark::DoNotOptimize(table.find(key));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK(BM_HashTableChains_FindDenseBuckets)
+    ->ArgsProduct({{100000, 1000000}, {1, 4, 8}});
+
+// ключи с GMP-хешем (double): рост с нуля, затем поиск по цепочкам
+// с одинаковыми хешами — у k + 0.25 и k + 0.5 хеш общий, и найти
+// ключ помогает только сравнение ключей
+static void BM_HashTableChains_GmpKeys(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    for (auto _ : state) {
+        HashTable<double, int, GmpHash> table(5, HashSetup::Fast);
+        for (size_t i = 0; i < n; i++) {
+            table.insert(i + 0.25, static_cast<int>(i));
+            table.insert(i + 0.5, static_cast<int>(i));
+        }
+        for (size_t i = 0; i < n; i++) {
+            benchmark::DoNotOptimize(table.find(i + 0.5));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * n * 3);
+}
+
+BENCHMARK(BM_HashTableChains_GmpKeys)
+    ->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+// строковые ключи со стандартным Hasher: рост с нуля и поиск
+static void BM_HashTableChains_StringKeys(benchmark::State& state) {
+    const size_t n = state.range(0);
+    std::vector<std::string> keys(n);
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = "user:" + std::to_string(i * 7919) + ":session";
+    }
+
+    for (auto _ : state) {
+        HashTable<std::string, int> table(5, HashSetup::Fast);
+        for (size_t i = 0; i < n; i++) {
+            table.insert(keys[i], static_cast<int>(i));
+        }
+        for (const std::string& key : keys) {
+            benchmark::DoNotOptimize(table.find(key));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * n * 2);
+}
+
+BENCHMARK(BM_HashTableChains_StringKeys)
+    ->Arg(10000)->Arg(100000)
+    ->Unit(benchmark::kMillisecond);
+
+// вставка с reserve: ни роста, ни переноса
+static void BM_HashTableChains_InsertReserved(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    for (auto _ : state) {
+        HashTable<int, int> table(5, HashSetup::Fast);
+        table.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            table.insert(static_cast<int>(i), static_cast<int>(i));
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_HashTableChains_InsertReserved)
+    ->Arg(1000)->Arg(100000)->Arg(1000000)
+    ->Unit(benchmark::kMillisecond);
+
+// цена конструктора: range(1) = 0 — HashSetup::Random (GMP-генератор и
+// mpz_nextprime), 1 — HashSetup::Fast (таблица простых, splitmix64)
+static void BM_HashTableChains_Construct(benchmark::State& state) {
+    const int capacity = state.range(0);
+    const HashSetup setup = state.range(1) ? HashSetup::Fast
+        : HashSetup::Random;
+
+    for (auto _ : state) {
+        HashTable<int, int> table(capacity, setup);
+        benchmark::DoNotOptimize(table);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HashTableChains_Construct)->ArgsProduct({{16, 1024}, {0, 1}});
+
 static void BM_HashTableChains_Find(benchmark::State& state) {
     const size_t n = state.range(0);
     auto data = generate_random_ints(n);
@@ -95,3 +294,250 @@ static void BM_HashTableChains_Remove(benchmark::State& state) {
 
 
 BENCHMARK(BM_HashTableChains_Remove)->Arg(1000)->Arg(5000)->Arg(10000);
+
+// Поток проверок, в котором 90% ключей отсутствуют (дедупликация).
+// range(1): 0 — без фильтра, 1 — с фильтром Блума перед таблицей.
+static void BM_HashTableChains_IsPresentMostlyMiss(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    HashTable<int, int> table(n * 2);
+    for (size_t i = 0; i < n; i++) {
+        table.insert(i, i);
+    }
+    if (state.range(1)) {
+        table.enableBloomFilter(n);
+    }
+
+    // каждый десятый запрос попадает, остальные — мимо
+    std::vector<int> queries(n);
+    for (size_t i = 0; i < n; i++) {
+        queries[i] = i % 10 == 0 ? i : n + i;
+    }
+
+    for (auto _ : state) {
+        for (int key : queries) {
+            benchmark::DoNotOptimize(table.isPresent(key));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_HashTableChains_IsPresentMostlyMiss)
+    ->ArgsProduct({{10000, 100000}, {0, 1}});
+
+// CHURN
+// Поток вытеснений: удалить случайный ключ, вставить новый. Таблица
+// плотная (8 ключей на корзину), так что большая часть пар живёт в
+// узлах переполнения. Table — HashTable с пулом узлов (по умолчанию)
+// или с std::allocator; rss_delta_mb — прирост RSS после заполнения
+// и прогона.
+template <typename Table>
+static void churn(benchmark::State& state) {
+    const size_t n = state.range(0);
+    double rssBefore = residentMegabytes();
+
+    auto table = std::make_unique<Table>(static_cast<int>(n / 8),
+        HashSetup::Fast);
+    table->setMaxLoadFactor(16.0f);
+    std::vector<int> live(n);
+    for (size_t i = 0; i < n; i++) {
+        live[i] = static_cast<int>(i);
+        table->insert(live[i], live[i]);
+    }
+
+    std::mt19937 rng(12345);
+    int next = static_cast<int>(n);
+    for (auto _ : state) {
+        for (int op = 0; op < 1000; op++) {
+            size_t victim = rng() % n;
+            table->remove(live[victim]);
+            live[victim] = next++;
+            table->insert(live[victim], 0);
+        }
+    }
+
+    state.counters["rss_delta_mb"] = residentMegabytes() - rssBefore;
+    state.SetItemsProcessed(state.iterations() * 1000 * 2);
+}
+
+static void BM_HashTableChains_ChurnPool(benchmark::State& state) {
+    churn<HashTable<int, int>>(state);
+}
+
+static void BM_HashTableChains_ChurnHeap(benchmark::State& state) {
+    churn<HashTable<int, int, hashing::Hash<int>,
+        std::allocator<Pair<int, int>>>>(state);
+}
+
+BENCHMARK(BM_HashTableChains_ChurnPool)->Arg(100000)->Arg(1000000);
+BENCHMARK(BM_HashTableChains_ChurnHeap)->Arg(100000)->Arg(1000000);
+
+// clean() большой плотной таблицы: с пулом плиты освобождаются разом,
+// без обхода узлов
+template <typename Table>
+static void cleanDense(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        Table table(static_cast<int>(n / 8), HashSetup::Fast);
+        table.setMaxLoadFactor(16.0f);
+        for (size_t i = 0; i < n; i++) {
+            table.insert(static_cast<int>(i), static_cast<int>(i));
+        }
+        state.ResumeTiming();
+
+        table.clean();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+static void BM_HashTableChains_CleanPool(benchmark::State& state) {
+    cleanDense<HashTable<int, int>>(state);
+}
+
+static void BM_HashTableChains_CleanHeap(benchmark::State& state) {
+    cleanDense<HashTable<int, int, hashing::Hash<int>,
+        std::allocator<Pair<int, int>>>>(state);
+}
+
+BENCHMARK(BM_HashTableChains_CleanPool)->Arg(1000000)->Iterations(5);
+BENCHMARK(BM_HashTableChains_CleanHeap)->Arg(1000000)->Iterations(5);
+
+
+// Масштабирование по потокам: общий HashTable под одним mutex (как
+// сейчас в слое кэша) против ConcurrentHashTableChains с полосами
+// спин-замков. range(0) — процент записей (поровну вставки и
+// удаления), остальное — поиск; ключей вдвое больше, чем в таблице.
+
+static constexpr int kSharedKeyRange = 1 << 18;
+
+// HashTable за одним замком: весь доступ по очереди
+class MutexHashTable {
+ public:
+    explicit MutexHashTable(size_t capacity)
+        : table(static_cast<int>(capacity), HashSetup::Fast) {}
+
+    bool insert(int key, int value) {
+        std::lock_guard lock(mutex);
+        size_t before = table.getSize();
+        table.insert(key, value);
+        return table.getSize() != before;
+    }
+
+    int find(int key) {
+        std::lock_guard lock(mutex);
+        return table.find(key);
+    }
+
+    bool remove(int key) {
+        std::lock_guard lock(mutex);
+        return table.remove(key).has_value();
+    }
+
+ private:
+    std::mutex mutex;
+    HashTable<int, int> table;
+};
+
+template <typename Table>
+static void run_shared(benchmark::State& state,
+                       std::unique_ptr<Table>& shared) {
+    if (state.thread_index() == 0) {
+        shared = std::make_unique<Table>(kSharedKeyRange);
+        for (int key = 0; key < kSharedKeyRange; key += 2) {
+            shared->insert(key, key);
+        }
+    }
+    const int writePercent = static_cast<int>(state.range(0));
+
+    std::mt19937 rng(state.thread_index() + 1);
+    std::uniform_int_distribution<int> keyDist(0, kSharedKeyRange - 1);
+    std::uniform_int_distribution<int> opDist(0, 99);
+
+    for (auto _ : state) {
+        int key = keyDist(rng);
+        if (opDist(rng) >= writePercent) {
+            benchmark::DoNotOptimize(shared->find(key));
+        } else if (key & 1) {
+            benchmark::DoNotOptimize(shared->insert(key, key));
+        } else {
+            benchmark::DoNotOptimize(shared->remove(key));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        shared.reset();
+    }
+}
+
+static void BM_HashTableChains_SharedMutex(benchmark::State& state) {
+    static std::unique_ptr<MutexHashTable> table;
+    run_shared(state, table);
+}
+
+static void BM_HashTableChains_SharedStriped(benchmark::State& state) {
+    static std::unique_ptr<ConcurrentHashTableChains<int, int>> table;
+    run_shared(state, table);
+}
+
+BENCHMARK(BM_HashTableChains_SharedMutex)
+    ->Arg(5)->Arg(50)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_HashTableChains_SharedStriped)
+    ->Arg(5)->Arg(50)->ThreadRange(1, 16)->UseRealTime();
+
+// Передача таблицы между стадиями конвейера: стадия принимает таблицу
+// по значению и возвращает её дальше. range(1) = 0 — вызывающий
+// оставляет таблицу себе (копия), 1 — отдаёт через std::move.
+static HashTable<int, int> passStage(HashTable<int, int> table) {
+    return table;
+}
+
+static void BM_HashTableChains_HandOff(benchmark::State& state) {
+    const int n = state.range(0);
+    const bool move = state.range(1) != 0;
+
+    HashTable<int, int> table(5, HashSetup::Fast);
+    for (int i = 0; i < n; i++) {
+        table.insert(i, i);
+    }
+
+    for (auto _ : state) {
+        if (move) {
+            table = passStage(std::move(table));
+        } else {
+            HashTable<int, int> result = passStage(table);
+            benchmark::DoNotOptimize(result.getSize());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_HashTableChains_HandOff)
+    ->ArgsProduct({{1000, 100000, 1000000}, {0, 1}});
+
+// вектор таблиц без reserve: при росте вектора таблицы переносятся
+static void BM_HashTableChains_VectorOfTables(benchmark::State& state) {
+    const int tables = state.range(0);
+
+    for (auto _ : state) {
+        std::vector<HashTable<int, int>> shards;
+        for (int t = 0; t < tables; t++) {
+            shards.emplace_back(512, HashSetup::Fast);
+            for (int i = 0; i < 512; i++) {
+                shards.back().insert(i, t);
+            }
+        }
+        benchmark::DoNotOptimize(shards.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * tables);
+}
+
+BENCHMARK(BM_HashTableChains_VectorOfTables)->Arg(16)->Arg(256)
+    ->Unit(benchmark::kMicrosecond);
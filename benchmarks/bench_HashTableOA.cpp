@@ -2,6 +2,8 @@
 #include "../include/HashTableOA.hpp"
 #include <random>
 #include <vector>
+#include <chrono>
+#include <cstdio>
 
 static std::vector<int> generate_random_ints(size_t n) {
     std::mt19937 rng(12345);
@@ -53,6 +55,28 @@ static void BM_HashTable_Find(benchmark::State& state) {
 
 BENCHMARK(BM_HashTable_Find)->Arg(1000)->Arg(5000)->Arg(10000)->Arg(50000);
 
+// то же самое в режиме HashMode::Fast: маска вместо двух делений
+static void BM_HashTable_FindFast(benchmark::State& state) {
+    const size_t capacity = state.range(0);
+
+    auto data = generate_random_ints(capacity);
+    HashTableOA<int, int> table(capacity, HashMode::Fast);
+
+    for (size_t i = 0; i < capacity; i++) {
+        table.insert(data[i], i);
+    }
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < capacity; i++) {
+            benchmark::DoNotOptimize(table.find(data[i]));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * capacity);
+}
+
+BENCHMARK(BM_HashTable_FindFast)->Arg(1000)->Arg(5000)->Arg(10000)->Arg(50000);
+
 // REMOVE BENCHMARK
 static void BM_HashTable_Remove(benchmark::State& state) {
     const size_t capacity = state.range(0);
@@ -78,3 +102,434 @@ static void BM_HashTable_Remove(benchmark::State& state) {
 
 
 BENCHMARK(BM_HashTable_Remove)->Arg(1000)->Arg(5000)->Arg(10000);
+
+// GROWTH BENCHMARK
+// таблица стартует с ёмкости 16 и растёт до n ключей;
+// max_insert_ns показывает самую долгую одиночную вставку
+static void BM_HashTable_InsertGrowing(benchmark::State& state) {
+    const size_t n = state.range(0);
+    double maxInsertNs = 0.0;
+
+    for (auto _ : state) {
+        HashTableOA<int, int> table(16);
+
+        for (size_t i = 0; i < n; i++) {
+            auto start = std::chrono::steady_clock::now();
+            table.insert(static_cast<int>(i), static_cast<int>(i));
+            auto stop = std::chrono::steady_clock::now();
+
+            double ns = std::chrono::duration<double, std::nano>(
+                stop - start).count();
+            if (ns > maxInsertNs) maxInsertNs = ns;
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["max_insert_ns"] = maxInsertNs;
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_HashTable_InsertGrowing)
+    ->Arg(1000)->Arg(100000)->Arg(1000000)->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+
+// поиск, перемешанный со вставками во время роста
+static void BM_HashTable_FindWhileGrowing(benchmark::State& state) {
+    const size_t n = state.range(0);
+
+    for (auto _ : state) {
+        HashTableOA<int, int> table(16);
+
+        for (size_t i = 0; i < n; i++) {
+            table.insert(static_cast<int>(i), static_cast<int>(i));
+            benchmark::DoNotOptimize(table.find(static_cast<int>(i / 2)));
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n * 2);
+}
+
+BENCHMARK(BM_HashTable_FindWhileGrowing)
+    ->Arg(1000)->Arg(100000)->Arg(1000000)->Arg(10000000)
+    ->Unit(benchmark::kMillisecond);
+
+// FIND AT FIXED LOAD FACTOR
+// аргументы: число ключей и заполненность в процентах;
+// половина запросов — промахи
+//
+// items/s, -O2, до и после перехода на управляющие байты + SSE2-группы:
+//   load    100K keys (до -> после)   1M keys (до -> после)
+//   0.5     27.5M -> 41.1M            15.4M -> 20.8M
+//   0.6     22.0M -> 43.1M            12.6M -> 19.3M
+//   0.7     22.9M -> 35.8M            14.8M -> 19.5M
+//   0.8     13.4M -> 34.5M            12.1M -> 22.8M
+//   0.9     16.7M -> 35.7M            13.4M -> 31.1M
+static void BM_HashTable_FindAtLoad(benchmark::State& state) {
+    const size_t n = state.range(0);
+    const float load = static_cast<float>(state.range(1)) / 100.0f;
+    const size_t capacity = static_cast<size_t>(n / load);
+
+    HashTableOA<int, int> table(capacity);
+    table.setMaxLoadFactor(0.95f);
+    for (size_t i = 0; i < n; i++) {
+        table.insert(static_cast<int>(i * 2), static_cast<int>(i));
+    }
+
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(n * 2 - 1));
+    std::vector<int> queries(n);
+    for (size_t i = 0; i < n; i++) queries[i] = dist(rng);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; i++) {
+            benchmark::DoNotOptimize(table.find(queries[i]));
+        }
+    }
+
+    state.counters["load"] = table.getLoadFactor();
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_HashTable_FindAtLoad)
+    ->ArgsProduct({{100000, 1000000}, {50, 60, 70, 80, 90}});
+
+// CHURN BENCHMARK
+// размер таблицы постоянный: каждый цикл удаляет самый старый ключ,
+// вставляет новый и ищет случайный живой;
+// аргументы: число ключей и политика (0 — Linear, 1 — RobinHood)
+static void BM_HashTable_Churn(benchmark::State& state) {
+    const size_t n = state.range(0);
+    const ProbingPolicy policy = state.range(1) == 0
+        ? ProbingPolicy::Linear : ProbingPolicy::RobinHood;
+    const size_t cycles = 2'000'000;
+
+    HashTableOA<int, int> table(static_cast<int>(n / 0.7), policy);
+    table.setMaxLoadFactor(0.9f);
+    for (size_t i = 0; i < n; i++) {
+        table.insert(static_cast<int>(i), static_cast<int>(i));
+    }
+
+    std::mt19937 rng(12345);
+    int next = static_cast<int>(n);
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < cycles; i++) {
+            table.remove(next - static_cast<int>(n));
+            table.insert(next, next);
+            next++;
+
+            int alive = next - 1 - static_cast<int>(rng() % n);
+            benchmark::DoNotOptimize(table.find(alive));
+        }
+    }
+
+    state.counters["capacity"] = table.getCapacity();
+    state.SetItemsProcessed(state.iterations() * cycles * 3);
+}
+
+BENCHMARK(BM_HashTable_Churn)
+    ->ArgsProduct({{10000, 1000000}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+// STRING KEYS
+// ключи-URL одинаковой длины (аргумент), 100K ключей
+static std::vector<std::string> generate_urls(size_t n, size_t length) {
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> letter('a', 'z');
+    std::vector<std::string> v(n);
+    for (size_t i = 0; i < n; ++i) {
+        std::string url = "https://ex.io/" + std::to_string(i) + "/";
+        while (url.size() < length) url.push_back(static_cast<char>(letter(rng)));
+        url.resize(length);
+        v[i] = url;
+    }
+    return v;
+}
+
+static void BM_HashTable_StringFind(benchmark::State& state) {
+    const size_t n = 100000;
+    auto keys = generate_urls(n, state.range(0));
+    const HashMode mode = state.range(1) == 0
+        ? HashMode::Universal : HashMode::Fast;
+
+    HashTableOA<std::string, int> table(n * 2, mode);
+    for (size_t i = 0; i < n; i++) {
+        table.insert(keys[i], static_cast<int>(i));
+    }
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; i++) {
+            benchmark::DoNotOptimize(table.find(keys[i]));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * n * state.range(0));
+}
+
+BENCHMARK(BM_HashTable_StringFind)
+    ->ArgsProduct({{24, 40, 100, 200}, {0, 1}});
+
+static void BM_HashTable_StringInsert(benchmark::State& state) {
+    const size_t n = 100000;
+    auto keys = generate_urls(n, state.range(0));
+
+    for (auto _ : state) {
+        HashTableOA<std::string, int> table(16, HashMode::Fast);
+        for (size_t i = 0; i < n; i++) {
+            table.insert(keys[i], static_cast<int>(i));
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_HashTable_StringInsert)
+    ->Arg(24)->Arg(40)->Arg(100)->Arg(200)
+    ->Unit(benchmark::kMillisecond);
+
+// поиск по подстроке запроса: std::string_view против временной строки
+// и find_ptr против find; аргумент 0 — std::string + find,
+// 1 — string_view + find, 2 — string_view + find_ptr
+static void BM_HashTable_StringLookupPath(benchmark::State& state) {
+    const size_t n = 100000;
+    auto keys = generate_urls(n, 100);
+    std::vector<std::string> requests(n);
+    for (size_t i = 0; i < n; i++) {
+        requests[i] = "GET " + keys[i] + " HTTP/1.1";
+    }
+
+    HashTableOA<std::string, std::string> table(n * 2, HashMode::Fast);
+    for (size_t i = 0; i < n; i++) {
+        table.insert(keys[i], keys[i]);
+    }
+
+    const int variant = state.range(0);
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; i++) {
+            std::string_view path =
+                std::string_view(requests[i]).substr(4, 100);
+            if (variant == 0) {
+                benchmark::DoNotOptimize(table.find(std::string(path)));
+            } else if (variant == 1) {
+                benchmark::DoNotOptimize(table.find(path));
+            } else {
+                benchmark::DoNotOptimize(table.find_ptr(path));
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_HashTable_StringLookupPath)->Arg(0)->Arg(1)->Arg(2);
+
+// HEAVY VALUES
+// значение держит вектор из 256 чисел; аргумент 0 — insert (копия),
+// 1 — insert_or_assign(std::move), 2 — try_emplace (конструирование
+// в ячейке)
+struct HeavyValue {
+    std::vector<int> samples;
+    std::string label;
+
+    HeavyValue() = default;
+    HeavyValue(size_t n, int seed)
+        : samples(n, seed), label("value-" + std::to_string(seed)) {}
+};
+
+static void BM_HashTable_InsertHeavyValue(benchmark::State& state) {
+    const size_t n = 50000;
+    const int variant = state.range(0);
+
+    for (auto _ : state) {
+        HashTableOA<int, HeavyValue> table(16, HashMode::Fast);
+
+        for (size_t i = 0; i < n; i++) {
+            int key = static_cast<int>(i);
+            if (variant == 0) {
+                HeavyValue value(256, key);
+                table.insert(key, value);
+            } else if (variant == 1) {
+                HeavyValue value(256, key);
+                table.insert_or_assign(key, std::move(value));
+            } else {
+                table.try_emplace(key, 256, key);
+            }
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_HashTable_InsertHeavyValue)
+    ->Arg(0)->Arg(1)->Arg(2)
+    ->Unit(benchmark::kMillisecond);
+
+// BATCHED LOOKUP
+// таблица больше кэша последнего уровня, 1M случайных запросов за
+// итерацию; аргументы: число ключей и способ (0 — find_ptr в цикле,
+// 1 — find_batch)
+static void BM_HashTable_FindBatch(benchmark::State& state) {
+    const size_t n = state.range(0);
+    const bool batched = state.range(1) == 1;
+    const size_t queries = 1'000'000;
+
+    HashTableOA<int, int> table(static_cast<int>(n / 0.7), HashMode::Fast);
+    for (size_t i = 0; i < n; i++) {
+        table.insert(static_cast<int>(i), static_cast<int>(i));
+    }
+
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(n * 2 - 1));
+    std::vector<int> keys(queries);
+    for (size_t i = 0; i < queries; i++) keys[i] = dist(rng);
+    std::vector<int*> out(queries);
+
+    for (auto _ : state) {
+        if (batched) {
+            benchmark::DoNotOptimize(table.find_batch(keys, out));
+        } else {
+            for (size_t i = 0; i < queries; i++) {
+                out[i] = table.find_ptr(keys[i]);
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * queries);
+}
+
+BENCHMARK(BM_HashTable_FindBatch)
+    ->ArgsProduct({{1 << 20, 16 << 20, 64 << 20}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+// цена счётчиков пробирования: range(1) = 1 — HashTableOA<..., true>
+template <bool Telemetry>
+static void find_with_telemetry(benchmark::State& state) {
+    const size_t capacity = state.range(0);
+
+    auto data = generate_random_ints(capacity);
+    HashTableOA<int, int, Telemetry> table(capacity, HashMode::Fast);
+
+    for (size_t i = 0; i < capacity; i++) {
+        table.insert(data[i], i);
+    }
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < capacity; i++) {
+            benchmark::DoNotOptimize(table.find(data[i]));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * capacity);
+}
+
+static void BM_HashTable_FindTelemetry(benchmark::State& state) {
+    if (state.range(1)) {
+        find_with_telemetry<true>(state);
+    } else {
+        find_with_telemetry<false>(state);
+    }
+}
+
+BENCHMARK(BM_HashTable_FindTelemetry)
+    ->ArgsProduct({{10000, 1000000}, {0, 1}});
+
+// ЗАГРУЗКА С ДИСКА: loadBinary перехеширует каждую пару,
+// loadSnapshot отображает файл и работает по нему на месте.
+// range(1): 0 — loadBinary, 1 — снимок с проверкой суммы,
+// 2 — снимок без проверки (только отображение, страницы лениво)
+//
+// 1M пар int/int, -O2:  loadBinary 58 ms, снимок 1.5 ms,
+// снимок без проверки 0.02 ms
+static void BM_HashTable_LoadFromDisk(benchmark::State& state) {
+    const int n = state.range(0);
+    const int how = state.range(1);
+
+    {
+        HashTableOA<int, int> table(n * 2);
+        for (int i = 0; i < n; i++) {
+            table.insert(i, i);
+        }
+        if (how == 0) {
+            table.saveBinary("bench_htoa_load.bin");
+        } else {
+            table.saveSnapshot("bench_htoa_load.bin");
+        }
+    }
+
+    for (auto _ : state) {
+        HashTableOA<int, int> loaded(0);
+        if (how == 0) {
+            loaded.loadBinary("bench_htoa_load.bin");
+        } else {
+            loaded.loadSnapshot("bench_htoa_load.bin", how == 1);
+        }
+        benchmark::DoNotOptimize(loaded.find(n / 2));
+    }
+
+    std::remove("bench_htoa_load.bin");
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_HashTable_LoadFromDisk)
+    ->ArgsProduct({{100000, 1000000}, {0, 1, 2}})
+    ->Unit(benchmark::kMillisecond);
+
+// Передача таблицы между стадиями конвейера: стадия принимает таблицу
+// по значению и возвращает её дальше. range(1) = 0 — вызывающий
+// оставляет таблицу себе (копия), 1 — отдаёт через std::move.
+static HashTableOA<int, int> passStage(HashTableOA<int, int> table) {
+    return table;
+}
+
+static void BM_HashTable_HandOff(benchmark::State& state) {
+    const int n = state.range(0);
+    const bool move = state.range(1) != 0;
+
+    HashTableOA<int, int> table(n * 2, HashMode::Fast);
+    for (int i = 0; i < n; i++) {
+        table.insert(i, i);
+    }
+
+    for (auto _ : state) {
+        if (move) {
+            table = passStage(std::move(table));
+        } else {
+            HashTableOA<int, int> result = passStage(table);
+            benchmark::DoNotOptimize(result.getSize());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_HashTable_HandOff)
+    ->ArgsProduct({{1000, 100000, 1000000}, {0, 1}});
+
+// вектор таблиц без reserve: при росте вектора таблицы переносятся
+static void BM_HashTable_VectorOfTables(benchmark::State& state) {
+    const int tables = state.range(0);
+
+    for (auto _ : state) {
+        std::vector<HashTableOA<int, int>> shards;
+        for (int t = 0; t < tables; t++) {
+            shards.emplace_back(1024, HashMode::Fast);
+            for (int i = 0; i < 512; i++) {
+                shards.back().insert(i, t);
+            }
+        }
+        benchmark::DoNotOptimize(shards.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * tables);
+}
+
+BENCHMARK(BM_HashTable_VectorOfTables)->Arg(16)->Arg(256)
+    ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>
+#include "../include/HashTableOA.hpp"
+#include "../include/ShardedHashTableOA.hpp"
+#include <memory>
+#include <mutex>
+#include <random>
+
+// Многопоточные смеси чтение/запись: range(0) — процент чтений
+// (95 или 50), остальное поровну вставки и удаления, так что размер
+// таблицы держится около половины диапазона ключей. Сравнение с одной
+// HashTableOA под общим mutex: поиск в ней может переносить ячейки при
+// перестройке, поэтому замок там нужен исключительный и на чтение.
+
+static constexpr int kKeyRange = 1 << 20;
+
+// HashTableOA целиком под одним замком
+class GlobalLockTableOA {
+ public:
+    explicit GlobalLockTableOA(int capacity) : table(capacity, HashMode::Fast) {}
+
+    bool insert(int key, int value) {
+        std::lock_guard lock(mutex);
+        return table.insert(key, value);
+    }
+
+    int find(int key) {
+        std::lock_guard lock(mutex);
+        return table.find(key);
+    }
+
+    bool remove(int key) {
+        std::lock_guard lock(mutex);
+        return table.remove(key);
+    }
+
+ private:
+    std::mutex mutex;
+    HashTableOA<int, int> table;
+};
+
+template <typename Table>
+static void run_mix(benchmark::State& state, std::unique_ptr<Table>& shared) {
+    const int readPercent = state.range(0);
+
+    // заполняет нулевой поток; цикл ниже стартует у всех потоков
+    // одновременно, уже после заполнения
+    if (state.thread_index() == 0) {
+        shared = std::make_unique<Table>(kKeyRange);
+        for (int key = 0; key < kKeyRange; key += 2) {
+            shared->insert(key, key);
+        }
+    }
+
+    std::mt19937 rng(state.thread_index() + 1);
+    std::uniform_int_distribution<int> keyDist(0, kKeyRange - 1);
+    std::uniform_int_distribution<int> opDist(0, 99);
+
+    for (auto _ : state) {
+        int key = keyDist(rng);
+        int op = opDist(rng);
+        if (op < readPercent) {
+            benchmark::DoNotOptimize(shared->find(key));
+        } else if (op & 1) {
+            benchmark::DoNotOptimize(shared->insert(key, key));
+        } else {
+            benchmark::DoNotOptimize(shared->remove(key));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        shared.reset();
+    }
+}
+
+static void BM_Sharded_Mix(benchmark::State& state) {
+    static std::unique_ptr<ShardedHashTableOA<int, int>> table;
+    run_mix(state, table);
+}
+
+BENCHMARK(BM_Sharded_Mix)->Arg(95)->Arg(50)
+    ->ThreadRange(1, 64)->UseRealTime();
+
+static void BM_GlobalLock_Mix(benchmark::State& state) {
+    static std::unique_ptr<GlobalLockTableOA> table;
+    run_mix(state, table);
+}
+
+BENCHMARK(BM_GlobalLock_Mix)->Arg(95)->Arg(50)
+    ->ThreadRange(1, 64)->UseRealTime();
@@ -3,6 +3,7 @@
 #include <random>
 #include <vector>
 #include "../include/DL_List.hpp"
+#include "../include/NodePool.hpp"
 
 static std::vector<int> generate_random_ints(size_t n) {
     std::mt19937 rng(12345);
@@ -103,3 +104,34 @@ static void BM_DLList_Copy(benchmark::State& state) {
     state.SetItemsProcessed(state.iterations() * n);
 }
 BENCHMARK(BM_DLList_Copy)->Arg(1000)->Arg(5000)->Arg(10000);
+
+// очередь из n элементов: снять голову, добавить в хвост;
+// range(1): 0 — узлы из кучи, 1 — из NodePool
+static void BM_DLList_Churn(benchmark::State& state) {
+    const size_t n = state.range(0);
+    NodePool pool;
+
+    auto run = [&](auto& list) {
+        for (size_t i = 0; i < n; i++) {
+            list.addTail(static_cast<int>(i));
+        }
+        int next = static_cast<int>(n);
+        for (auto _ : state) {
+            for (int op = 0; op < 1000; op++) {
+                list.unlink(list.getHead());
+                list.addTail(next++);
+            }
+        }
+    };
+
+    if (state.range(1)) {
+        DL_list<int, PoolAllocator<int>> list{PoolAllocator<int>(pool)};
+        run(list);
+    } else {
+        DL_list<int> list;
+        run(list);
+    }
+
+    state.SetItemsProcessed(state.iterations() * 1000 * 2);
+}
+BENCHMARK(BM_DLList_Churn)->ArgsProduct({{1000, 100000}, {0, 1}});
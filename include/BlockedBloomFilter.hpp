@@ -0,0 +1,144 @@
+// Copyright message
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "../include/HashFunctions.hpp"
+
+// Блочный фильтр Блума: все k битов ключа лежат в одном блоке
+// размером с кэш-линию, поэтому проверка — одно обращение к памяти.
+// Ложные срабатывания возможны, ложные промахи — нет. Фильтр получает
+// уже посчитанный 64-битный хеш ключа.
+//
+// Удалить ключ из фильтра нельзя; владелец сообщает об удалениях через
+// noteRemoval() и перестраивает фильтр, когда needsRebuild() говорит,
+// что в нём слишком много устаревших битов или он переполнен.
+class BlockedBloomFilter {
+ public:
+    // expectedKeys — сколько ключей ожидается, falsePositiveRate —
+    // желаемая доля ложных срабатываний для такого числа ключей
+    explicit BlockedBloomFilter(size_t expectedKeys,
+                                double falsePositiveRate = 0.01)
+        : expected(std::max<size_t>(expectedKeys, 1)) {
+        if (falsePositiveRate <= 0.0 || falsePositiveRate >= 1.0) {
+            falsePositiveRate = 0.01;
+        }
+
+        // классические формулы m = -n ln p / ln²2, k = m/n ln 2;
+        // блочность немного повышает долю срабатываний, это учтено
+        // запасом в 1.2 по числу битов
+        double ln2 = std::log(2.0);
+        double bits = -static_cast<double>(expected)
+            * std::log(falsePositiveRate) / (ln2 * ln2) * 1.2;
+        size_t blocks = static_cast<size_t>(bits) / kBlockBits + 1;
+        blockCount = std::bit_ceil(blocks);
+
+        double perKey = static_cast<double>(blockCount * kBlockBits)
+            / static_cast<double>(expected);
+        hashCount = static_cast<uint32_t>(std::clamp(
+            std::lround(perKey * ln2), 1L, static_cast<long>(kMaxHashes)));
+
+        blocks_ = std::make_unique<Block[]>(blockCount);
+    }
+
+    BlockedBloomFilter(const BlockedBloomFilter& other)
+        : expected(other.expected),
+          blockCount(other.blockCount),
+          hashCount(other.hashCount),
+          added(other.added),
+          removed(other.removed),
+          blocks_(std::make_unique<Block[]>(other.blockCount)) {
+        std::copy(other.blocks_.get(), other.blocks_.get() + blockCount,
+            blocks_.get());
+    }
+
+    BlockedBloomFilter& operator=(const BlockedBloomFilter&) = delete;
+
+    void add(uint64_t hash) {
+        Block& block = blocks_[blockIndex(hash)];
+        forEachBit(hash, [&](uint32_t bit) {
+            block.words[bit / 64] |= 1ull << (bit % 64);
+        });
+        added++;
+    }
+
+    // false — ключа точно нет; true — ключ, вероятно, есть
+    bool mayContain(uint64_t hash) const {
+        const Block& block = blocks_[blockIndex(hash)];
+        bool all = true;
+        forEachBit(hash, [&](uint32_t bit) {
+            all &= (block.words[bit / 64] >> (bit % 64)) & 1;
+        });
+        return all;
+    }
+
+    void noteRemoval() {
+        removed++;
+    }
+
+    // перестраивать, если удалённые составляют четверть добавленных
+    // или ключей вдвое больше, чем рассчитывали
+    bool needsRebuild() const {
+        return removed * 4 > added || added > expected * 2;
+    }
+
+    void clear() {
+        std::fill(blocks_.get(), blocks_.get() + blockCount, Block());
+        added = 0;
+        removed = 0;
+    }
+
+    size_t getExpected() const {
+        return expected;
+    }
+
+    size_t getAdded() const {
+        return added;
+    }
+
+    size_t getRemoved() const {
+        return removed;
+    }
+
+    uint32_t getHashCount() const {
+        return hashCount;
+    }
+
+    size_t sizeInBytes() const {
+        return blockCount * sizeof(Block);
+    }
+
+ private:
+    static constexpr size_t kBlockBits = 512;
+    static constexpr uint32_t kMaxHashes = 16;
+
+    struct alignas(64) Block {
+        uint64_t words[kBlockBits / 64] = {};
+    };
+
+    size_t expected;
+    size_t blockCount = 1;
+    uint32_t hashCount = 1;
+    size_t added = 0;
+    size_t removed = 0;
+    std::unique_ptr<Block[]> blocks_;
+
+    size_t blockIndex(uint64_t hash) const {
+        return hash & (blockCount - 1);
+    }
+
+    // биты внутри блока — двойным хешированием из перемешанного хеша:
+    // старшие 9 бит от a + i * b
+    template <typename F>
+    void forEachBit(uint64_t hash, F&& f) const {
+        uint64_t g = hashing::mix(hash, hashing::kSecret2);
+        uint32_t a = static_cast<uint32_t>(g);
+        uint32_t b = static_cast<uint32_t>(g >> 32) | 1;
+        for (uint32_t i = 0; i < hashCount; i++) {
+            f((a + i * b) >> (32 - 9));
+        }
+    }
+};
@@ -0,0 +1,321 @@
+// Copyright message
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "../include/HashFunctions.hpp"
+#include "../include/NodePool.hpp"
+
+// Спин-замок на одном байте: захват — exchange, ожидание — чтение без
+// записи (линия не прыгает между ядрами), после серии попыток поток
+// уступает процессор. Подходит для коротких критических секций.
+class SpinLock {
+ public:
+    void lock() noexcept {
+        while (locked.exchange(true, std::memory_order_acquire)) {
+            for (int spins = 0; locked.load(std::memory_order_relaxed);
+                    spins++) {
+                if (spins < kSpinsBeforeYield) {
+                    cpuRelax();
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        }
+    }
+
+    bool try_lock() noexcept {
+        return !locked.load(std::memory_order_relaxed)
+            && !locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() noexcept {
+        locked.store(false, std::memory_order_release);
+    }
+
+ private:
+    static constexpr int kSpinsBeforeYield = 64;
+
+    std::atomic<bool> locked{false};
+
+    static void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+};
+
+// Цепочечная хеш-таблица для нескольких потоков. Корзины защищены
+// полосами спин-замков: корзина i принадлежит полосе i mod lockCount.
+// Число полос не меняется, ёмкость — степень двойки не меньше его,
+// поэтому при росте пара остаётся в своей полосе, а пока ёмкость равна
+// lockCount, у каждой корзины свой замок. Операции над разными
+// полосами не мешают друг другу; рост берёт все замки по порядку.
+//
+// У каждой полосы свой NodePool и свой счётчик пар: узлы выделяются
+// без общего замка, а рост запускает полоса, в которой на корзину
+// пришлось больше kMaxLoadFactor пар. Узел хранит полный хеш, так что
+// рост только перецепляет узлы.
+//
+// Семантика как у HashTable: insert не заменяет значение уже
+// существующего ключа, remove возвращает удалённое значение.
+template <typename Key, typename Value>
+class ConcurrentHashTableChains {
+ public:
+    explicit ConcurrentHashTableChains(size_t capacity,
+                                       size_t lockCount = 256) {
+        lockCount = std::bit_ceil(std::max<size_t>(lockCount, 1));
+        stripes = std::make_unique<Stripe[]>(lockCount);
+        stripeCount = lockCount;
+
+        std::random_device rd;
+        seed = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+
+        size_t buckets = std::bit_ceil(std::max(capacity, lockCount));
+        heads = std::make_unique<Node*[]>(buckets);
+        bucketCount.store(buckets, std::memory_order_relaxed);
+    }
+
+    ConcurrentHashTableChains(const ConcurrentHashTableChains&) = delete;
+    ConcurrentHashTableChains& operator=(const ConcurrentHashTableChains&)
+        = delete;
+
+    ~ConcurrentHashTableChains() {
+        destroyNodes();
+    }
+
+    // true — ключ добавлен, false — ключ уже был, значение не тронуто
+    bool insert(const Key& key, const Value& value) {
+        uint64_t hash = hashKey(key);
+        Stripe& stripe = stripeFor(hash);
+        size_t observed;
+        bool overloaded;
+        {
+            std::lock_guard lock(stripe.lock);
+            Node*& head = bucketFor(hash);
+            if (findIn(head, key, hash)) {
+                return false;
+            }
+            head = createNode(stripe, key, value, hash, head);
+
+            size_t count = stripe.count.load(std::memory_order_relaxed) + 1;
+            stripe.count.store(count, std::memory_order_relaxed);
+            observed = bucketCount.load(std::memory_order_relaxed);
+            overloaded = count > std::max<double>(kMinStripeEntries,
+                observed / stripeCount * kMaxLoadFactor);
+        }
+        if (overloaded) {
+            grow(observed);
+        }
+        return true;
+    }
+
+    std::optional<Value> remove(const Key& key) {
+        uint64_t hash = hashKey(key);
+        Stripe& stripe = stripeFor(hash);
+        std::lock_guard lock(stripe.lock);
+        for (Node** link = &bucketFor(hash); *link; link = &(*link)->next) {
+            Node* node = *link;
+            if (node->hash == hash && node->key == key) {
+                std::optional<Value> value(std::move(node->value));
+                *link = node->next;
+                destroyNode(stripe, node);
+                stripe.count.store(
+                    stripe.count.load(std::memory_order_relaxed) - 1,
+                    std::memory_order_relaxed);
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // копия значения или nullopt; указатель наружу отдать нельзя,
+    // потому что замок полосы снимается при выходе
+    std::optional<Value> try_get(const Key& key) const {
+        uint64_t hash = hashKey(key);
+        std::lock_guard lock(stripeFor(hash).lock);
+        if (const Node* node = findIn(bucketFor(hash), key, hash)) {
+            return node->value;
+        }
+        return std::nullopt;
+    }
+
+    Value find(const Key& key) const {
+        std::optional<Value> value = try_get(key);
+        return value ? *value : Value();
+    }
+
+    bool isPresent(const Key& key) const {
+        uint64_t hash = hashKey(key);
+        std::lock_guard lock(stripeFor(hash).lock);
+        return findIn(bucketFor(hash), key, hash) != nullptr;
+    }
+
+    // сумма по полосам; при параллельных записях — приблизительно
+    size_t getSize() const {
+        size_t total = 0;
+        for (size_t i = 0; i < stripeCount; i++) {
+            total += stripes[i].count.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    size_t getCapacity() const {
+        return bucketCount.load(std::memory_order_relaxed);
+    }
+
+    size_t getLockCount() const {
+        return stripeCount;
+    }
+
+    // ёмкость сохраняется, узлы и плиты пулов освобождаются
+    void clean() {
+        lockAll();
+        destroyNodes();
+        size_t buckets = bucketCount.load(std::memory_order_relaxed);
+        std::fill(heads.get(), heads.get() + buckets, nullptr);
+        for (size_t i = 0; i < stripeCount; i++) {
+            stripes[i].pool.release();
+            stripes[i].count.store(0, std::memory_order_relaxed);
+        }
+        unlockAll();
+    }
+
+ private:
+    // пар на корзину полосы, после которых таблица удваивается
+    static constexpr double kMaxLoadFactor = 1.0;
+    // пока корзин мало, полосу не растят из-за пары случайных коллизий
+    static constexpr size_t kMinStripeEntries = 4;
+
+    struct Node {
+        Key key;
+        Value value;
+        uint64_t hash;
+        Node* next;
+    };
+
+    // замок, счётчик и пул полосы на своей кэш-линии
+    struct alignas(64) Stripe {
+        SpinLock lock;
+        std::atomic<size_t> count{0};
+        NodePool pool;
+    };
+
+    std::unique_ptr<Stripe[]> stripes;
+    size_t stripeCount = 0;
+    // меняются только под всеми замками; читаются под замком полосы
+    std::unique_ptr<Node*[]> heads;
+    std::atomic<size_t> bucketCount{0};
+    uint64_t seed = 0;
+
+    uint64_t hashKey(const Key& key) const {
+        if constexpr (std::is_integral_v<Key> || std::is_enum_v<Key>) {
+            return hashing::mix(static_cast<uint64_t>(key) ^ seed,
+                hashing::kSecret1);
+        } else if constexpr (std::is_convertible_v<const Key&,
+                std::string_view>) {
+            return hashing::hashBytes(std::string_view(key), seed);
+        } else {
+            static_assert(std::is_trivially_copyable_v<Key>,
+                "ConcurrentHashTableChains: unsupported key type");
+            return hashing::hashBytes(&key, sizeof(Key), seed);
+        }
+    }
+
+    Stripe& stripeFor(uint64_t hash) const {
+        return stripes[hash & (stripeCount - 1)];
+    }
+
+    // только под замком полосы хеша
+    Node*& bucketFor(uint64_t hash) const {
+        size_t buckets = bucketCount.load(std::memory_order_relaxed);
+        return heads[hash & (buckets - 1)];
+    }
+
+    static Node* findIn(Node* node, const Key& key, uint64_t hash) {
+        for (; node; node = node->next) {
+            if (node->hash == hash && node->key == key) {
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    static Node* createNode(Stripe& stripe, const Key& key,
+                            const Value& value, uint64_t hash, Node* next) {
+        void* memory = stripe.pool.allocate(sizeof(Node), alignof(Node));
+        try {
+            return new (memory) Node{key, value, hash, next};
+        } catch (...) {
+            stripe.pool.deallocate(memory, sizeof(Node), alignof(Node));
+            throw;
+        }
+    }
+
+    static void destroyNode(Stripe& stripe, Node* node) {
+        node->~Node();
+        stripe.pool.deallocate(node, sizeof(Node), alignof(Node));
+    }
+
+    // Узлы всех корзин. Память пула вернёт release() разом, поэтому
+    // обход нужен, только если у пар есть деструкторы или узлы из-за
+    // выравнивания взяты из обычной кучи.
+    void destroyNodes() {
+        if constexpr (!(std::is_trivially_destructible_v<Node>
+                && alignof(Node) <= alignof(std::max_align_t))) {
+            size_t buckets = bucketCount.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < buckets; i++) {
+                while (Node* node = heads[i]) {
+                    heads[i] = node->next;
+                    destroyNode(stripeFor(node->hash), node);
+                }
+            }
+        }
+    }
+
+    void lockAll() const {
+        for (size_t i = 0; i < stripeCount; i++) {
+            stripes[i].lock.lock();
+        }
+    }
+
+    void unlockAll() const {
+        for (size_t i = 0; i < stripeCount; i++) {
+            stripes[i].lock.unlock();
+        }
+    }
+
+    // Удвоение под всеми замками. Если пока мы ждали замки, таблицу
+    // уже вырастил другой поток, ничего не делаем.
+    void grow(size_t observed) {
+        lockAll();
+        size_t buckets = bucketCount.load(std::memory_order_relaxed);
+        if (buckets == observed) {
+            size_t fresh = buckets * 2;
+            auto table = std::make_unique<Node*[]>(fresh);
+            for (size_t i = 0; i < buckets; i++) {
+                while (Node* node = heads[i]) {
+                    heads[i] = node->next;
+                    Node*& head = table[node->hash & (fresh - 1)];
+                    node->next = head;
+                    head = node;
+                }
+            }
+            heads = std::move(table);
+            bucketCount.store(fresh, std::memory_order_relaxed);
+        }
+        unlockAll();
+    }
+};
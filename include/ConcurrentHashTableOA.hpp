@@ -0,0 +1,440 @@
+// Copyright message
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <type_traits>
+#include <vector>
+#include "../include/HashFunctions.hpp"
+
+// Открытая адресация с чтением без замков. Слоты собраны в группы по 16,
+// у каждой группы счётчик версий в духе seqlock: писатель делает его
+// нечётным на время изменения группы, читатель проверяет, что версия
+// не поменялась, пока он смотрел группу, и иначе перечитывает её.
+// Писатели упорядочены общим mutex.
+//
+// Ключи и значения хранятся в std::atomic и читаются relaxed, поэтому
+// оба типа должны быть тривиально копируемыми и lock-free.
+//
+// Старый массив после перестройки может ещё читать поток, взявший его
+// до публикации нового, поэтому он освобождается с задержкой, по
+// эпохам: читатель отмечается в счётчике чётности текущей эпохи,
+// писатель переводит эпоху дальше, только когда счётчик прошлой эпохи
+// обнулился, и тогда освобождает массивы, убранные до неё. Читатели
+// не ждут никогда, писатели тоже: неосвобождённых массивов остаётся
+// не больше, чем перестроек за время самого долгого чтения.
+template <typename Key, typename Value>
+class ConcurrentHashTableOA {
+    static_assert(std::is_trivially_copyable_v<Key>
+        && std::is_trivially_copyable_v<Value>,
+        "ConcurrentHashTableOA needs trivially copyable Key and Value");
+    static_assert(std::atomic<Key>::is_always_lock_free
+        && std::atomic<Value>::is_always_lock_free,
+        "ConcurrentHashTableOA needs lock-free atomic Key and Value");
+
+ public:
+    explicit ConcurrentHashTableOA(size_t capacity) {
+        std::random_device rd;
+        seed = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+        current.store(allocateTable(groupsFor(capacity)),
+            std::memory_order_release);
+    }
+
+    ConcurrentHashTableOA(const ConcurrentHashTableOA&) = delete;
+    ConcurrentHashTableOA& operator=(const ConcurrentHashTableOA&) = delete;
+
+    // true — ключ добавлен, false — значение ключа перезаписано
+    bool insert(const Key& key, const Value& value) {
+        std::lock_guard lock(writeMutex);
+        uint64_t hash = hashKey(key);
+        Table* t = current.load(std::memory_order_relaxed);
+
+        Slot found = locate(*t, key, hash);
+        if (found.group != npos) {
+            Group& group = t->groups[found.group];
+            beginWrite(group);
+            group.values[found.index].store(value, std::memory_order_relaxed);
+            endWrite(group);
+            return false;
+        }
+
+        if (needsGrowth(*t)) {
+            t = grow();
+        }
+
+        Slot free = probeForInsert(*t, hash);
+        Group& group = t->groups[free.group];
+        bool reusedDeleted = ctrlAt(group, free.index) == kDeleted;
+        beginWrite(group);
+        group.keys[free.index].store(key, std::memory_order_relaxed);
+        group.values[free.index].store(value, std::memory_order_relaxed);
+        setCtrl(group, free.index, h2(hash));
+        endWrite(group);
+
+        if (reusedDeleted) {
+            deletedCount--;
+        }
+        size.fetch_add(1, std::memory_order_relaxed);
+        reclaim();
+        return true;
+    }
+
+    bool remove(const Key& key) {
+        std::lock_guard lock(writeMutex);
+        Table* t = current.load(std::memory_order_relaxed);
+        Slot found = locate(*t, key, hashKey(key));
+        if (found.group == npos) {
+            return false;
+        }
+
+        Group& group = t->groups[found.group];
+        beginWrite(group);
+        setCtrl(group, found.index, kDeleted);
+        endWrite(group);
+
+        deletedCount++;
+        size.fetch_sub(1, std::memory_order_relaxed);
+        reclaim();
+        return true;
+    }
+
+    // Поиск без замков: только атомарные чтения и повторы группы,
+    // если её как раз меняет писатель.
+    std::optional<Value> try_get(const Key& key) const {
+        uint64_t hash = hashKey(key);
+        ReadGuard guard(*this);
+        while (true) {
+            const Table* t = current.load(std::memory_order_acquire);
+            std::optional<Value> result = lookup(*t, key, hash);
+            // пока мы искали, писатель мог перенести всё в новый массив
+            // и уже записать туда; тогда ответ по старому устарел
+            if (current.load(std::memory_order_acquire) == t) {
+                return result;
+            }
+        }
+    }
+
+    Value find(const Key& key) const {
+        std::optional<Value> value = try_get(key);
+        return value ? *value : Value();
+    }
+
+    bool isPresent(const Key& key) const {
+        return try_get(key).has_value();
+    }
+
+    size_t getSize() const {
+        return size.load(std::memory_order_relaxed);
+    }
+
+    size_t getCapacity() const {
+        ReadGuard guard(*this);
+        return current.load(std::memory_order_acquire)->groupCount
+            * kGroupWidth;
+    }
+
+    // прежние массивы, которые ещё ждут освобождения
+    size_t getRetiredCount() const {
+        std::lock_guard lock(writeMutex);
+        return retired.size();
+    }
+
+    // Освобождает и прежние массивы, поэтому вызывать только когда
+    // параллельных читателей нет.
+    void clean() {
+        std::lock_guard lock(writeMutex);
+        size_t groups = current.load(std::memory_order_relaxed)->groupCount;
+        retired.clear();
+        owned.reset();
+        current.store(allocateTable(groups), std::memory_order_release);
+        size.store(0, std::memory_order_relaxed);
+        deletedCount = 0;
+    }
+
+ private:
+    static constexpr uint8_t kEmpty = 0x00;
+    static constexpr uint8_t kDeleted = 0x01;
+    static constexpr uint8_t kFull = 0x80;
+    static constexpr size_t kGroupWidth = 16;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    static constexpr uint64_t kLowBytes = 0x0101010101010101ull;
+    static constexpr uint64_t kHighBits = 0x8080808080808080ull;
+
+    // управляющие байты группы лежат в двух 64-битных словах,
+    // их сравнивают сразу по 8 байт
+    struct alignas(64) Group {
+        std::atomic<uint32_t> version{0};
+        std::atomic<uint64_t> ctrl[2] = {};
+        std::atomic<Key> keys[kGroupWidth] = {};
+        std::atomic<Value> values[kGroupWidth] = {};
+    };
+
+    struct Table {
+        std::unique_ptr<Group[]> groups;
+        size_t groupCount;
+    };
+
+    struct Slot {
+        size_t group;
+        size_t index;
+    };
+
+    // массив, убранный перестройкой в эпоху epoch
+    struct Retired {
+        std::unique_ptr<Table> table;
+        uint64_t epoch;
+    };
+
+    // Отметка читателя в счётчике чётности эпохи. Если эпоха сменилась
+    // между чтением и отметкой, отметка переносится в новую: писатель
+    // мог уже проверить старый счётчик.
+    class ReadGuard {
+     public:
+        explicit ReadGuard(const ConcurrentHashTableOA& owner)
+            : counter(nullptr) {
+            while (true) {
+                uint64_t e = owner.epoch.load(std::memory_order_seq_cst);
+                counter = &owner.activeReaders[e & 1];
+                counter->fetch_add(1, std::memory_order_seq_cst);
+                if (owner.epoch.load(std::memory_order_seq_cst) == e) {
+                    return;
+                }
+                counter->fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        ~ReadGuard() {
+            counter->fetch_sub(1, std::memory_order_release);
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+     private:
+        std::atomic<size_t>* counter;
+    };
+
+    std::atomic<Table*> current{nullptr};
+    std::unique_ptr<Table> owned;
+    std::vector<Retired> retired;
+    mutable std::mutex writeMutex;
+    // эпоха меняется только под writeMutex
+    std::atomic<uint64_t> epoch{0};
+    mutable std::atomic<size_t> activeReaders[2] = {};
+    std::atomic<size_t> size{0};
+    size_t deletedCount = 0;
+    uint64_t seed = 0;
+
+    static size_t groupsFor(size_t capacity) {
+        return std::bit_ceil(std::max<size_t>(1,
+            (capacity + kGroupWidth - 1) / kGroupWidth));
+    }
+
+    Table* allocateTable(size_t groupCount) {
+        auto table = std::make_unique<Table>();
+        table->groups = std::make_unique<Group[]>(groupCount);
+        table->groupCount = groupCount;
+        if (owned) {
+            retired.push_back({std::move(owned),
+                epoch.load(std::memory_order_relaxed)});
+        }
+        owned = std::move(table);
+        return owned.get();
+    }
+
+    uint64_t hashKey(const Key& key) const {
+        if constexpr (std::is_integral_v<Key> || std::is_enum_v<Key>) {
+            return hashing::mix(static_cast<uint64_t>(key) ^ seed,
+                hashing::kSecret1);
+        } else {
+            return hashing::hashBytes(&key, sizeof(Key), seed);
+        }
+    }
+
+    static uint8_t h2(uint64_t hash) {
+        return kFull | static_cast<uint8_t>(hash & 0x7F);
+    }
+
+    size_t homeGroup(const Table& t, uint64_t hash) const {
+        return (hash >> 7) & (t.groupCount - 1);
+    }
+
+    // SWAR-поиск байта в слове; ложные срабатывания возможны только
+    // выше настоящего совпадения
+    static uint64_t matchByte(uint64_t word, uint8_t byte) {
+        uint64_t x = word ^ (kLowBytes * byte);
+        return (x - kLowBytes) & ~x & kHighBits;
+    }
+
+    static uint8_t ctrlAt(const Group& group, size_t index) {
+        uint64_t word = group.ctrl[index / 8].load(std::memory_order_relaxed);
+        return static_cast<uint8_t>(word >> ((index % 8) * 8));
+    }
+
+    // только под writeMutex: читать-изменять-писать здесь некому больше
+    static void setCtrl(Group& group, size_t index, uint8_t value) {
+        std::atomic<uint64_t>& cell = group.ctrl[index / 8];
+        uint64_t shift = (index % 8) * 8;
+        uint64_t word = cell.load(std::memory_order_relaxed);
+        word = (word & ~(0xFFull << shift))
+            | (static_cast<uint64_t>(value) << shift);
+        cell.store(word, std::memory_order_relaxed);
+    }
+
+    static void beginWrite(Group& group) {
+        uint32_t v = group.version.load(std::memory_order_relaxed);
+        group.version.store(v + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    static void endWrite(Group& group) {
+        uint32_t v = group.version.load(std::memory_order_relaxed);
+        group.version.store(v + 1, std::memory_order_release);
+    }
+
+    // Один проход по цепочке групп без замка. Каждая группа читается
+    // целиком и принимается, только если её версия чётная и не
+    // изменилась за время чтения.
+    std::optional<Value> lookup(const Table& t, const Key& key,
+                                uint64_t hash) const {
+        uint8_t tag = h2(hash);
+        size_t g = homeGroup(t, hash);
+        for (size_t step = 0; step < t.groupCount; step++) {
+            const Group& group = t.groups[g];
+            while (true) {
+                uint32_t before = group.version.load(std::memory_order_acquire);
+                if (before & 1) {
+                    continue;
+                }
+
+                std::optional<Value> found;
+                bool hasEmpty = false;
+                for (size_t w = 0; w < 2 && !found; w++) {
+                    uint64_t word = group.ctrl[w].load(
+                        std::memory_order_relaxed);
+                    for (uint64_t m = matchByte(word, tag); m; m &= m - 1) {
+                        size_t bit = std::countr_zero(m) & ~7;
+                        // ложное совпадение SWAR: байт сверяем точно,
+                        // чтобы не читать чужой ключ
+                        if (static_cast<uint8_t>(word >> bit) != tag) {
+                            continue;
+                        }
+                        size_t i = w * 8 + bit / 8;
+                        if (group.keys[i].load(std::memory_order_relaxed)
+                                == key) {
+                            found = group.values[i].load(
+                                std::memory_order_relaxed);
+                            break;
+                        }
+                    }
+                    hasEmpty |= matchByte(word, kEmpty) != 0;
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (group.version.load(std::memory_order_relaxed) != before) {
+                    continue;
+                }
+                if (found || hasEmpty) {
+                    return found;
+                }
+                break;
+            }
+            g = (g + 1) & (t.groupCount - 1);
+        }
+        return std::nullopt;
+    }
+
+    // дальше — только под writeMutex, версии можно не проверять
+    Slot locate(const Table& t, const Key& key, uint64_t hash) const {
+        uint8_t tag = h2(hash);
+        size_t g = homeGroup(t, hash);
+        for (size_t step = 0; step < t.groupCount; step++) {
+            const Group& group = t.groups[g];
+            for (size_t i = 0; i < kGroupWidth; i++) {
+                uint8_t c = ctrlAt(group, i);
+                if (c == tag
+                    && group.keys[i].load(std::memory_order_relaxed) == key) {
+                    return {g, i};
+                }
+                if (c == kEmpty) {
+                    return {npos, 0};
+                }
+            }
+            g = (g + 1) & (t.groupCount - 1);
+        }
+        return {npos, 0};
+    }
+
+    Slot probeForInsert(const Table& t, uint64_t hash) const {
+        size_t g = homeGroup(t, hash);
+        while (true) {
+            const Group& group = t.groups[g];
+            for (size_t i = 0; i < kGroupWidth; i++) {
+                if ((ctrlAt(group, i) & kFull) == 0) {
+                    return {g, i};
+                }
+            }
+            g = (g + 1) & (t.groupCount - 1);
+        }
+    }
+
+    bool needsGrowth(const Table& t) const {
+        size_t capacity = t.groupCount * kGroupWidth;
+        return (getSize() + deletedCount + 1) * 4 > capacity * 3;
+    }
+
+    // Новый массив заполняется целиком, пока его никто не видит, и
+    // публикуется одной release-записью. Если больше половины занятого —
+    // надгробия, размер прежний: перестройка их просто вычищает.
+    Table* grow() {
+        Table* old = current.load(std::memory_order_relaxed);
+        size_t groups = deletedCount > getSize()
+            ? old->groupCount : old->groupCount * 2;
+        Table* fresh = allocateTable(groups);
+
+        for (size_t g = 0; g < old->groupCount; g++) {
+            const Group& group = old->groups[g];
+            for (size_t i = 0; i < kGroupWidth; i++) {
+                if ((ctrlAt(group, i) & kFull) == 0) {
+                    continue;
+                }
+                Key key = group.keys[i].load(std::memory_order_relaxed);
+                uint64_t hash = hashKey(key);
+                Slot slot = probeForInsert(*fresh, hash);
+                Group& target = fresh->groups[slot.group];
+                target.keys[slot.index].store(key, std::memory_order_relaxed);
+                target.values[slot.index].store(
+                    group.values[i].load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+                setCtrl(target, slot.index, h2(hash));
+            }
+        }
+
+        deletedCount = 0;
+        current.store(fresh, std::memory_order_seq_cst);
+        reclaim();
+        return fresh;
+    }
+
+    // Только под writeMutex. Когда читателей прошлой эпохи не осталось,
+    // все читатели зашли уже после публикации массивов, убранных до
+    // текущей эпохи; их можно освободить и перейти к следующей эпохе.
+    void reclaim() {
+        if (retired.empty()) {
+            return;
+        }
+        uint64_t e = epoch.load(std::memory_order_relaxed);
+        if (activeReaders[(e + 1) & 1].load(std::memory_order_seq_cst) != 0) {
+            return;
+        }
+        std::erase_if(retired, [e](const Retired& r) {
+            return r.epoch < e;
+        });
+        epoch.store(e + 1, std::memory_order_seq_cst);
+    }
+};
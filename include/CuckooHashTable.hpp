@@ -0,0 +1,468 @@
+// Copyright message
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "../include/HashFunctions.hpp"
+
+// Кукушкино хеширование с корзинами: у каждого ключа ровно две корзины
+// по 4 ячейки, и ключ всегда лежит в одной из них. Поиск смотрит не
+// больше двух корзин независимо от заполнения. Вставка при полных
+// корзинах выталкивает случайного соседа в его вторую корзину; если
+// цепочка вытеснений слишком длинная, таблица удваивается.
+template <typename Key, typename Value>
+class CuckooHashTable {
+ public:
+    // как в HashTableOA: строковые ключи ищутся по std::string_view
+    using LookupKey = std::conditional_t<
+        std::is_convertible_v<const Key&, std::string_view>,
+        std::string_view, Key>;
+
+    explicit CuckooHashTable(int capacity) : size(0) {
+        std::random_device rd;
+        seed = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+        allocate(bucketsFor(capacity > 0 ? capacity : 0));
+    }
+
+    CuckooHashTable(const CuckooHashTable& other)
+        : size(0), seed(other.seed), maxLoadFactor(other.maxLoadFactor) {
+        allocate(other.bucketCount);
+        try {
+            for (size_t b = 0; b < bucketCount; b++) {
+                for (size_t i = 0; i < kSlots; i++) {
+                    if (other.buckets[b].tags[i] != kEmpty) {
+                        new (cellAt(b, i)) Cell(*other.cellAt(b, i));
+                        buckets[b].tags[i] = other.buckets[b].tags[i];
+                        size++;
+                    }
+                }
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    CuckooHashTable& operator=(const CuckooHashTable& other) {
+        if (this != &other) {
+            CuckooHashTable tmp(other);
+            swap(tmp);
+        }
+
+        return *this;
+    }
+
+    ~CuckooHashTable() {
+        release();
+    }
+
+    // вставка или замена значения, как insert у HashTableOA
+    bool insert(const Key& key, const Value& value) {
+        uint64_t hash = hashValue(key);
+        if (Cell* cell = locate(key, hash)) {
+            cell->value = value;
+            return true;
+        }
+
+        if (static_cast<float>(size + 1)
+                > maxLoadFactor * static_cast<float>(getCapacity())) {
+            rehash(bucketCount * 2);
+        }
+        place(Cell{key, value}, hash);
+        size++;
+        return true;
+    }
+
+    bool isPresent(const LookupKey& key) const {
+        return find_ptr(key) != nullptr;
+    }
+
+    Value find(const LookupKey& key) const {
+        const Value* value = find_ptr(key);
+        return value ? *value : Value();
+    }
+
+    const Value* find_ptr(const LookupKey& key) const {
+        const Cell* cell = locate(key, hashValue(key));
+        return cell ? &cell->value : nullptr;
+    }
+
+    Value* find_ptr(const LookupKey& key) {
+        Cell* cell = locate(key, hashValue(key));
+        return cell ? &cell->value : nullptr;
+    }
+
+    // удаление не оставляет надгробий: ячейка просто освобождается
+    bool remove(const LookupKey& key) {
+        uint64_t hash = hashValue(key);
+        uint8_t tag = h2(hash);
+        for (size_t b : {firstBucket(hash), secondBucket(hash)}) {
+            for (size_t i = 0; i < kSlots; i++) {
+                if (buckets[b].tags[i] == tag && cellAt(b, i)->key == key) {
+                    cellAt(b, i)->~Cell();
+                    buckets[b].tags[i] = kEmpty;
+                    size--;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void print() const {
+        for (size_t b = 0; b < bucketCount; b++) {
+            std::cout << b << ":";
+            for (size_t i = 0; i < kSlots; i++) {
+                if (buckets[b].tags[i] != kEmpty) {
+                    std::cout << " {" << cellAt(b, i)->key << ": "
+                        << cellAt(b, i)->value << "}";
+                }
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    // оставляет пустую таблицу минимального размера
+    void clean() {
+        release();
+        size = 0;
+        allocate(bucketsFor(0));
+    }
+
+    size_t getSize() const {
+        return size;
+    }
+
+    size_t getCapacity() const {
+        return bucketCount * kSlots;
+    }
+
+    float getLoadFactor() const {
+        if (bucketCount == 0) {
+            return 0.0f;
+        }
+        return static_cast<float>(size) / getCapacity();
+    }
+
+    // 4-путные корзины держат заполнение до ~95%, по умолчанию 0.9
+    void setMaxLoadFactor(float factor) {
+        if (factor <= 0.0f || factor > 1.0f) {
+            throw std::invalid_argument("Max load factor must be in (0, 1]");
+        }
+        maxLoadFactor = factor;
+    }
+
+    float getMaxLoadFactor() const {
+        return maxLoadFactor;
+    }
+
+    // текстовый формат: размер и ёмкость, затем пары
+    void saveText(const std::string& filename) const {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            throw std::runtime_error("Cannot open file for writing");
+        }
+
+        file << size << " " << getCapacity() << "\n";
+        forEach([&](const Cell& cell) {
+            file << cell.key << " " << cell.value << "\n";
+        });
+        file.close();
+    }
+
+    void loadText(const std::string& filename) {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            throw std::runtime_error("Cannot open file for reading");
+        }
+
+        release();
+        size = 0;
+
+        size_t oldSize;
+        size_t oldCapacity;
+        file >> oldSize >> oldCapacity;
+        allocate(bucketsFor(oldCapacity));
+
+        for (size_t i = 0; i < oldSize; ++i) {
+            Key key;
+            Value value;
+            file >> key >> value;
+            insert(key, value);
+        }
+        file.close();
+    }
+
+    // бинарный формат
+    void saveBinary(const std::string& filename) const {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Cannot open file for writing");
+        }
+
+        size_t capacity = getCapacity();
+        file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        file.write(reinterpret_cast<const char*>(&capacity), sizeof(capacity));
+        forEach([&](const Cell& cell) {
+            file.write(reinterpret_cast<const char*>(&cell.key), sizeof(Key));
+            file.write(reinterpret_cast<const char*>(&cell.value),
+                sizeof(Value));
+        });
+        file.close();
+    }
+
+    void loadBinary(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Cannot open file for reading");
+        }
+
+        release();
+        size = 0;
+
+        size_t oldSize;
+        size_t oldCapacity;
+        file.read(reinterpret_cast<char*>(&oldSize), sizeof(oldSize));
+        file.read(reinterpret_cast<char*>(&oldCapacity), sizeof(oldCapacity));
+        allocate(bucketsFor(oldCapacity));
+
+        for (size_t i = 0; i < oldSize; ++i) {
+            Key key;
+            Value value;
+            file.read(reinterpret_cast<char*>(&key), sizeof(Key));
+            file.read(reinterpret_cast<char*>(&value), sizeof(Value));
+            insert(key, value);
+        }
+        file.close();
+    }
+
+ private:
+    struct Cell {
+        Key key;
+        Value value;
+    };
+
+    static constexpr size_t kSlots = 4;
+    // 0 — пустая ячейка, иначе 0x80 | 7 бит хеша
+    static constexpr uint8_t kEmpty = 0x00;
+    static constexpr uint8_t kFull = 0x80;
+    // длина цепочки вытеснений, после которой таблица растёт
+    static constexpr size_t kMaxKicks = 500;
+
+    // метки и ячейки корзины лежат рядом: для небольших Key/Value
+    // корзина занимает одну кэш-линию
+    struct alignas(64) Bucket {
+        uint8_t tags[kSlots] = {};
+        alignas(Cell) unsigned char storage[kSlots * sizeof(Cell)];
+    };
+
+    Bucket* buckets = nullptr;
+    size_t bucketCount = 0;
+    size_t size;
+    uint64_t seed = 0;
+    float maxLoadFactor = 0.9f;
+    std::mt19937 kickRng{12345};
+
+    static size_t bucketsFor(size_t capacity) {
+        size_t count = (capacity + kSlots - 1) / kSlots;
+        return std::bit_ceil(count < 2 ? size_t{2} : count);
+    }
+
+    Cell* cellAt(size_t b, size_t i) {
+        return std::launder(reinterpret_cast<Cell*>(buckets[b].storage) + i);
+    }
+
+    const Cell* cellAt(size_t b, size_t i) const {
+        return std::launder(
+            reinterpret_cast<const Cell*>(buckets[b].storage) + i);
+    }
+
+    void allocate(size_t count) {
+        buckets = std::allocator<Bucket>().allocate(count);
+        for (size_t b = 0; b < count; b++) {
+            new (&buckets[b]) Bucket();
+        }
+        bucketCount = count;
+    }
+
+    void release() {
+        if (!buckets) {
+            return;
+        }
+        if constexpr (!std::is_trivially_destructible_v<Cell>) {
+            for (size_t b = 0; b < bucketCount; b++) {
+                for (size_t i = 0; i < kSlots; i++) {
+                    if (buckets[b].tags[i] != kEmpty) {
+                        cellAt(b, i)->~Cell();
+                    }
+                }
+            }
+        }
+        std::allocator<Bucket>().deallocate(buckets, bucketCount);
+        buckets = nullptr;
+        bucketCount = 0;
+    }
+
+    template <typename F>
+    void forEach(F&& f) const {
+        for (size_t b = 0; b < bucketCount; b++) {
+            for (size_t i = 0; i < kSlots; i++) {
+                if (buckets[b].tags[i] != kEmpty) {
+                    f(*cellAt(b, i));
+                }
+            }
+        }
+    }
+
+    uint64_t hashValue(const LookupKey& key) const {
+        if constexpr (std::is_same_v<LookupKey, std::string_view>) {
+            return hashing::hashBytes(key, seed);
+        } else if constexpr (std::is_integral_v<Key>) {
+            return hashing::mix(static_cast<uint64_t>(key) ^ seed,
+                0x9E3779B97F4A7C15ull ^ seed);
+        } else if constexpr (std::is_floating_point_v<Key>) {
+            // по битам, а не по значению: приведение к uint64_t обрезает
+            // дробную часть, а для отрицательных ключей это UB; +0 и -0
+            // Hash сводит к одному значению
+            return hashing::mix(hashing::Hash<Key>{}(key) ^ seed,
+                0x9E3779B97F4A7C15ull ^ seed);
+        } else {
+            uint64_t keyValue = 0;
+            for (char c : key) {
+                keyValue = keyValue * 131 + static_cast<unsigned char>(c);
+            }
+            return hashing::mix(keyValue ^ seed,
+                0x9E3779B97F4A7C15ull ^ seed);
+        }
+    }
+
+    static uint8_t h2(uint64_t hash) {
+        return static_cast<uint8_t>(kFull | (hash >> 57));
+    }
+
+    // две корзины берутся из разных половин хеша; если они совпали,
+    // вторая — соседняя, чтобы у ключа всегда было 8 ячеек
+    size_t firstBucket(uint64_t hash) const {
+        return hash & (bucketCount - 1);
+    }
+
+    size_t secondBucket(uint64_t hash) const {
+        size_t first = firstBucket(hash);
+        size_t second = (hash >> 32) & (bucketCount - 1);
+        return second != first ? second : first ^ 1;
+    }
+
+    const Cell* locate(const LookupKey& key, uint64_t hash) const {
+        uint8_t tag = h2(hash);
+        size_t first = firstBucket(hash);
+        size_t second = secondBucket(hash);
+#if defined(__GNUC__)
+        __builtin_prefetch(&buckets[second]);
+#endif
+        if (const Cell* cell = findInBucket(first, tag, key)) {
+            return cell;
+        }
+        return findInBucket(second, tag, key);
+    }
+
+    // четыре метки корзины сравниваются одним 32-битным словом
+    const Cell* findInBucket(size_t b, uint8_t tag,
+                             const LookupKey& key) const {
+        uint32_t tags;
+        std::memcpy(&tags, buckets[b].tags, sizeof(tags));
+        uint32_t x = tags ^ (0x01010101u * tag);
+        uint32_t match = (x - 0x01010101u) & ~x & 0x80808080u;
+        for (; match != 0; match &= match - 1) {
+            size_t i = std::countr_zero(match) / 8;
+            if (buckets[b].tags[i] == tag && cellAt(b, i)->key == key) {
+                return cellAt(b, i);
+            }
+        }
+        return nullptr;
+    }
+
+    Cell* locate(const LookupKey& key, uint64_t hash) {
+        return const_cast<Cell*>(
+            std::as_const(*this).locate(key, hash));
+    }
+
+    bool placeInBucket(size_t b, Cell&& cell, uint8_t tag) {
+        for (size_t i = 0; i < kSlots; i++) {
+            if (buckets[b].tags[i] == kEmpty) {
+                new (cellAt(b, i)) Cell(std::move(cell));
+                buckets[b].tags[i] = tag;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // ключа точно нет в таблице; размер не меняется
+    void place(Cell&& from, uint64_t hash) {
+        Cell entry(std::move(from));
+        uint8_t tag = h2(hash);
+        size_t b = firstBucket(hash);
+
+        if (placeInBucket(b, std::move(entry), tag)
+            || placeInBucket(secondBucket(hash), std::move(entry), tag)) {
+            return;
+        }
+
+        // случайное блуждание: кладём запись на место случайного
+        // соседа, а его отправляем в его другую корзину
+        for (size_t kick = 0; kick < kMaxKicks; kick++) {
+            size_t victim = kickRng() % kSlots;
+            std::swap(entry, *cellAt(b, victim));
+            std::swap(tag, buckets[b].tags[victim]);
+
+            hash = hashValue(entry.key);
+            b = firstBucket(hash) == b ? secondBucket(hash)
+                : firstBucket(hash);
+            if (placeInBucket(b, std::move(entry), tag)) {
+                return;
+            }
+        }
+
+        // вытолкнутая запись ещё у нас на руках: растём и кладём её
+        rehash(bucketCount * 2);
+        place(std::move(entry), hashValue(entry.key));
+    }
+
+    void rehash(size_t newBucketCount) {
+        Bucket* oldBuckets = buckets;
+        size_t oldCount = bucketCount;
+        allocate(newBucketCount);
+
+        for (size_t b = 0; b < oldCount; b++) {
+            for (size_t i = 0; i < kSlots; i++) {
+                if (oldBuckets[b].tags[i] == kEmpty) {
+                    continue;
+                }
+                Cell* cell = std::launder(
+                    reinterpret_cast<Cell*>(oldBuckets[b].storage) + i);
+                place(std::move(*cell), hashValue(cell->key));
+                cell->~Cell();
+            }
+        }
+        std::allocator<Bucket>().deallocate(oldBuckets, oldCount);
+    }
+
+    void swap(CuckooHashTable& other) noexcept {
+        std::swap(buckets, other.buckets);
+        std::swap(bucketCount, other.bucketCount);
+        std::swap(size, other.size);
+        std::swap(seed, other.seed);
+        std::swap(maxLoadFactor, other.maxLoadFactor);
+        std::swap(kickRng, other.kickRng);
+    }
+};
@@ -1,15 +1,17 @@
 // Copyright message
 #pragma once
 #include <iostream>
+#include <memory>
 #include <utility>
 #include <stdexcept>
 #include <string>
 #include <fstream>
 
-template <typename T>
+// Allocator — откуда берутся узлы: по умолчанию обычная куча,
+// PoolAllocator из NodePool.hpp — плиты пула с повторным использованием
+// освобождённых узлов.
+template <typename T, typename Allocator = std::allocator<T>>
 class DL_list {
-    template <typename K, typename V> friend class HashTable;
-
  private:
     struct Node {
     T value;
@@ -19,16 +21,26 @@ class DL_list {
         : value(v), next(n), previous(p) {}
     };
 
+    using NodeAllocator = typename std::allocator_traits<Allocator>
+        ::template rebind_alloc<Node>;
+    using NodeTraits = std::allocator_traits<NodeAllocator>;
+
     Node* head;
     Node* tail;
     int size;
+    [[no_unique_address]] NodeAllocator alloc;
 
  public:
     DL_list()
     : head(nullptr), tail(nullptr), size(0) {}
 
+    explicit DL_list(const Allocator& allocator)
+        : head(nullptr), tail(nullptr), size(0), alloc(allocator) {}
+
     DL_list(const DL_list& other)
-        : head(nullptr), tail(nullptr), size(0) {
+        : head(nullptr), tail(nullptr), size(0),
+          alloc(NodeTraits::select_on_container_copy_construction(
+              other.alloc)) {
         if (!other.head) {
             return;
         }
@@ -37,13 +49,13 @@ class DL_list {
         Node* newTail = nullptr;
 
         // копия через локальные переменные (strong exception safety)
-        newHead = new Node(other.head->value, nullptr, nullptr);
+        newHead = createNode(other.head->value, nullptr, nullptr);
         Node* curNew = newHead;
         Node* curOther = other.head->next;
 
         try {
             while (curOther) {
-                Node* n = new Node(curOther->value, nullptr, curNew);
+                Node* n = createNode(curOther->value, nullptr, curNew);
                 curNew->next = n;
                 curNew = n;
                 curOther = curOther->next;
@@ -54,7 +66,7 @@ class DL_list {
             Node* tmp = newHead;
             while (tmp) {
                 Node* next = tmp->next;
-                delete tmp;
+                destroyNode(tmp);
                 tmp = next;
             }
             throw;
@@ -65,12 +77,12 @@ class DL_list {
         size = other.size;
     }
 
-    DL_list<T>& operator=(const DL_list& other) {
+    DL_list& operator=(const DL_list& other) {
         if (this == &other) {
             return *this;
         }
 
-        DL_list<T> tmp(other);  // strong exception safety
+        DL_list tmp(other);  // strong exception safety
         swap(tmp);
         return *this;
     }
@@ -84,7 +96,7 @@ class DL_list {
         while (cur) {
             Node* tmp = cur;
             cur = cur->next;
-            delete tmp;
+            destroyNode(tmp);
         }
         head = tail = nullptr;
         size = 0;
@@ -103,7 +115,7 @@ class DL_list {
     }
 
     void addHead(const T& value) {
-        Node* newNode = new Node(value, head, nullptr);
+        Node* newNode = createNode(value, head, nullptr);
         if (head) {
             head->previous = newNode;
         }
@@ -113,7 +125,7 @@ class DL_list {
     }
 
     void addTail(const T& value) {
-        Node* newNode = new Node(value, nullptr, tail);
+        Node* newNode = createNode(value, nullptr, tail);
         if (tail) {
             tail->next = newNode;
         }
@@ -137,7 +149,7 @@ class DL_list {
             cur = cur->next;
         }
 
-        Node* newNode = new Node(value, cur->next, cur);
+        Node* newNode = createNode(value, cur->next, cur);
 
         if (cur->next) {
             cur->next->previous = newNode;
@@ -166,7 +178,7 @@ class DL_list {
             cur = cur->next;
         }
 
-        Node* newNode = new Node(value, cur, cur->previous);
+        Node* newNode = createNode(value, cur, cur->previous);
         if (cur->previous) {
             cur->previous->next = newNode;
         } else {
@@ -181,25 +193,30 @@ class DL_list {
         while (cur) {
             Node* next = cur->next;
             if (cur->value == value) {
-                if (cur->previous) {
-                    cur->previous->next = cur->next;
-                } else {
-                    head = cur->next;
-                }
-
-                if (cur->next) {
-                    cur->next->previous = cur->previous;
-                } else {
-                    tail = cur->previous;
-                }
-
-                delete cur;
-                --size;
+                unlink(cur);
             }
             cur = next;
         }
     }
 
+    // удаляет узел этого списка за O(1), без поиска
+    void unlink(Node* node) {
+        if (node->previous) {
+            node->previous->next = node->next;
+        } else {
+            head = node->next;
+        }
+
+        if (node->next) {
+            node->next->previous = node->previous;
+        } else {
+            tail = node->previous;
+        }
+
+        destroyNode(node);
+        --size;
+    }
+
     int searchByValue(const T& value) const {
         Node* cur = head;
         int index = 0;
@@ -317,5 +334,22 @@ class DL_list {
         std::swap(head, other.head);
         std::swap(tail, other.tail);
         std::swap(size, other.size);
+        std::swap(alloc, other.alloc);
+    }
+
+    Node* createNode(const T& value, Node* next, Node* previous) {
+        Node* node = NodeTraits::allocate(alloc, 1);
+        try {
+            NodeTraits::construct(alloc, node, value, next, previous);
+        } catch (...) {
+            NodeTraits::deallocate(alloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void destroyNode(Node* node) {
+        NodeTraits::destroy(alloc, node);
+        NodeTraits::deallocate(alloc, node, 1);
     }
 };
@@ -0,0 +1,215 @@
+// Copyright message
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "../include/HashFunctions.hpp"
+
+// Открытая адресация на N ключей с хранилищем внутри объекта: ни одной
+// аллокации, ёмкость — степень двойки не меньше 2N, ячейка берётся
+// маской. Всё constexpr, так что небольшой словарь можно собрать при
+// компиляции:
+//
+//     constexpr FixedHashTableOA<std::string_view, int, 3> kCodes = {
+//         {"ok", 200}, {"not found", 404}, {"teapot", 418}};
+//
+// Конструктор перебирает несколько солей хеша и оставляет ту, при
+// которой самый дальний ключ ближе всего к своей ячейке (0 — идеальное
+// хеширование). Поиск просматривает не больше maxProbe + 1 ячеек.
+//
+// Key и Value должны быть литеральными типами с конструктором по
+// умолчанию; строковые ключи — std::string_view или const char*.
+template <typename Key, typename Value, size_t N>
+class FixedHashTableOA {
+ public:
+    using LookupKey = std::conditional_t<
+        std::is_convertible_v<const Key&, std::string_view>,
+        std::string_view, Key>;
+
+    static constexpr size_t kCapacity = std::bit_ceil(N * 2);
+
+    constexpr FixedHashTableOA() = default;
+
+    constexpr FixedHashTableOA(
+            std::initializer_list<std::pair<Key, Value>> items) {
+        if (items.size() > N) {
+            throw std::length_error("FixedHashTableOA: too many items");
+        }
+
+        uint64_t bestSeed = 0;
+        size_t bestProbe = kCapacity;
+        for (uint64_t attempt = 0; attempt < kSeedAttempts; attempt++) {
+            rebuild(items, attempt);
+            if (maxProbe < bestProbe) {
+                bestProbe = maxProbe;
+                bestSeed = attempt;
+            }
+            if (bestProbe == 0) {
+                break;
+            }
+        }
+        rebuild(items, bestSeed);
+    }
+
+    // вставка или замена значения; false — таблица уже содержит N ключей
+    constexpr bool insert(const Key& key, const Value& value) {
+        size_t index = homeIndex(key);
+        for (size_t d = 0; d < kCapacity; d++) {
+            if (!used[index]) {
+                if (size == N) {
+                    return false;
+                }
+                used[index] = true;
+                keys[index] = key;
+                values[index] = value;
+                size++;
+                if (d > maxProbe) {
+                    maxProbe = d;
+                }
+                return true;
+            }
+            if (keys[index] == key) {
+                values[index] = value;
+                return true;
+            }
+            index = (index + 1) & kMask;
+        }
+        return false;
+    }
+
+    constexpr const Value* find_ptr(const LookupKey& key) const {
+        size_t index = slotOf(key);
+        return index == npos ? nullptr : &values[index];
+    }
+
+    constexpr Value find(const LookupKey& key) const {
+        const Value* value = find_ptr(key);
+        return value ? *value : Value();
+    }
+
+    constexpr bool isPresent(const LookupKey& key) const {
+        return slotOf(key) != npos;
+    }
+
+    // удаление со сдвигом хвоста цепочки назад: надгробий нет,
+    // и расстояния ключей только уменьшаются
+    constexpr bool remove(const LookupKey& key) {
+        size_t index = slotOf(key);
+        if (index == npos) {
+            return false;
+        }
+
+        size_t next = (index + 1) & kMask;
+        while (used[next]) {
+            size_t home = homeIndex(keys[next]);
+            // ключ из next можно перенести в index, если его домашняя
+            // ячейка не лежит строго между index и next
+            if (((next - home) & kMask) >= ((next - index) & kMask)) {
+                keys[index] = keys[next];
+                values[index] = values[next];
+                index = next;
+            }
+            next = (next + 1) & kMask;
+        }
+
+        used[index] = false;
+        keys[index] = Key();
+        values[index] = Value();
+        size--;
+        return true;
+    }
+
+    constexpr size_t getSize() const {
+        return size;
+    }
+
+    constexpr size_t getCapacity() const {
+        return kCapacity;
+    }
+
+    // наибольшее расстояние ключа от домашней ячейки
+    constexpr size_t getMaxProbe() const {
+        return maxProbe;
+    }
+
+ private:
+    static constexpr size_t kMask = kCapacity - 1;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    // сколько солей пробует конструктор
+    static constexpr uint64_t kSeedAttempts = 16;
+
+    std::array<Key, kCapacity> keys = {};
+    std::array<Value, kCapacity> values = {};
+    std::array<bool, kCapacity> used = {};
+    size_t size = 0;
+    size_t maxProbe = 0;
+    uint64_t seed = 0;
+
+    constexpr void rebuild(
+            std::initializer_list<std::pair<Key, Value>> items,
+            uint64_t newSeed) {
+        keys = {};
+        values = {};
+        used = {};
+        size = 0;
+        maxProbe = 0;
+        seed = newSeed;
+        for (const auto& [key, value] : items) {
+            insert(key, value);
+        }
+    }
+
+    constexpr size_t homeIndex(const LookupKey& key) const {
+        return hashKey(key) & kMask;
+    }
+
+    constexpr size_t slotOf(const LookupKey& key) const {
+        size_t index = homeIndex(key);
+        for (size_t d = 0; d <= maxProbe; d++) {
+            if (used[index] && keys[index] == key) {
+                return index;
+            }
+            index = (index + 1) & kMask;
+        }
+        return npos;
+    }
+
+    // hashing::hashBytes читает память через memcpy и в constexpr
+    // не годится, поэтому строки здесь хешируются своим циклом по 8 байт
+    constexpr uint64_t hashKey(const LookupKey& key) const {
+        uint64_t salt = hashing::mix(seed ^ hashing::kSecret0,
+            hashing::kSecret1);
+        if constexpr (std::is_same_v<LookupKey, std::string_view>) {
+            uint64_t h = salt ^ (key.size() * hashing::kSecret2);
+            size_t i = 0;
+            while (i < key.size()) {
+                uint64_t word = 0;
+                for (size_t j = 0; j < 8 && i < key.size(); j++, i++) {
+                    word |= static_cast<uint64_t>(
+                        static_cast<unsigned char>(key[i])) << (8 * j);
+                }
+                h = hashing::mix(h ^ word, hashing::kSecret1);
+            }
+            return hashing::mix(h, hashing::kSecret3);
+        } else if constexpr (std::is_floating_point_v<Key>) {
+            // по битам: приведение к uint64_t обрезает дробную часть,
+            // а для отрицательных и слишком больших значений это UB;
+            // -0 и +0 — один ключ
+            static_assert(sizeof(Key) == 4 || sizeof(Key) == 8,
+                "FixedHashTableOA: only float and double keys");
+            using Bits = std::conditional_t<sizeof(Key) == 4,
+                uint32_t, uint64_t>;
+            uint64_t bits = key == 0 ? 0 : std::bit_cast<Bits>(key);
+            return hashing::mix(bits ^ salt, hashing::kSecret1);
+        } else {
+            return hashing::mix(static_cast<uint64_t>(key) ^ salt,
+                hashing::kSecret1);
+        }
+    }
+};
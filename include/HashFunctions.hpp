@@ -0,0 +1,188 @@
+// Copyright message
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Общие хеш-функции для хеш-таблиц.
+namespace hashing {
+
+constexpr uint64_t kSecret0 = 0xa0761d6478bd642full;
+constexpr uint64_t kSecret1 = 0xe7037ed1a0b428dbull;
+constexpr uint64_t kSecret2 = 0x8ebc6af09c88c6e3ull;
+constexpr uint64_t kSecret3 = 0x589965cc75374cc3ull;
+
+// 64x64 -> 128 умножение: младшая половина в a, старшая в b
+constexpr void mum(uint64_t& a, uint64_t& b) {
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64_t>(r);
+    b = static_cast<uint64_t>(r >> 64);
+}
+
+constexpr uint64_t mix(uint64_t a, uint64_t b) {
+    mum(a, b);
+    return a ^ b;
+}
+
+// Арифметика по модулю простого Мерсенна 2^61 - 1: остаток от деления
+// сводится к сдвигу и сложению, без деления.
+constexpr uint64_t kMersenne61 = (1ull << 61) - 1;
+
+// x mod (2^61 - 1) для любого 64-битного x
+constexpr uint64_t reduce61(uint64_t x) {
+    x = (x & kMersenne61) + (x >> 61);
+    return x >= kMersenne61 ? x - kMersenne61 : x;
+}
+
+// a * b mod (2^61 - 1) для a, b < 2^61 - 1 через 128-битное произведение
+constexpr uint64_t mulMod61(uint64_t a, uint64_t b) {
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    uint64_t lo = static_cast<uint64_t>(r) & kMersenne61;
+    uint64_t hi = static_cast<uint64_t>(r >> 61);
+    return reduce61(lo + hi);
+}
+
+// splitmix64: дешёвый генератор для параметров хеша, продвигает state
+constexpr uint64_t splitmix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t read8(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t read4(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 1..3 байта: первый, средний и последний
+inline uint64_t read3(const uint8_t* p, size_t len) {
+    return (static_cast<uint64_t>(p[0]) << 16)
+        | (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+}
+
+// Хеш массива байтов в стиле wyhash: читаем по 8 байт, длинные ключи
+// идут тремя независимыми цепочками умножений по 48 байт за шаг,
+// так что процессор считает их параллельно.
+inline uint64_t hashBytes(const void* data, size_t len, uint64_t seed = 0) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    seed ^= mix(seed ^ kSecret0, kSecret1);
+
+    uint64_t a;
+    uint64_t b;
+    if (len <= 16) {
+        if (len >= 4) {
+            size_t shift = (len >> 3) << 2;
+            a = (read4(p) << 32) | read4(p + shift);
+            b = (read4(p + len - 4) << 32) | read4(p + len - 4 - shift);
+        } else if (len > 0) {
+            a = read3(p, len);
+            b = 0;
+        } else {
+            a = 0;
+            b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t seed1 = seed;
+            uint64_t seed2 = seed;
+            do {
+                seed = mix(read8(p) ^ kSecret1, read8(p + 8) ^ seed);
+                seed1 = mix(read8(p + 16) ^ kSecret2, read8(p + 24) ^ seed1);
+                seed2 = mix(read8(p + 32) ^ kSecret3, read8(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16) {
+            seed = mix(read8(p) ^ kSecret1, read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = read8(p + i - 16);
+        b = read8(p + i - 8);
+    }
+
+    a ^= kSecret1;
+    b ^= seed;
+    mum(a, b);
+    return mix(a ^ kSecret0 ^ len, b ^ kSecret1);
+}
+
+inline uint64_t hashBytes(std::string_view s, uint64_t seed = 0) {
+    return hashBytes(s.data(), s.size(), seed);
+}
+
+template <typename T>
+inline constexpr bool kIsTupleLike = false;
+
+template <typename A, typename B>
+inline constexpr bool kIsTupleLike<std::pair<A, B>> = true;
+
+template <typename... Ts>
+inline constexpr bool kIsTupleLike<std::tuple<Ts...>> = true;
+
+template <typename T, typename = void>
+inline constexpr bool kHasStdHash = false;
+
+template <typename T>
+inline constexpr bool kHasStdHash<T, std::void_t<
+    decltype(std::hash<T>{}(std::declval<const T&>()))>> = true;
+
+// Ключ -> 64 бита для HashTable (таблица сверху применяет свой
+// универсальный хеш по модулю 2^61 - 1, поэтому целые передаются
+// как есть):
+//   - целые и перечисления — своё значение;
+//   - float и double — биты числа (+0 и -0 дают одно и то же);
+//   - строки (всё, что приводится к std::string_view) — hashBytes;
+//   - std::pair и std::tuple — хеши элементов, сведённые через mix;
+//   - типы со специализацией std::hash — она;
+//   - остальные структуры без дыр в представлении — hashBytes по байтам.
+// Для прочих ключей нужен свой Hasher.
+template <typename T>
+struct Hash {
+    uint64_t operator()(const T& value) const {
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+            return static_cast<uint64_t>(value);
+        } else if constexpr (std::is_floating_point_v<T> && sizeof(T) <= 8) {
+            if (value == 0) {
+                return 0;
+            }
+            uint64_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(T));
+            return bits;
+        } else if constexpr (std::is_convertible_v<const T&,
+                std::string_view>) {
+            return hashBytes(std::string_view(value));
+        } else if constexpr (kIsTupleLike<T>) {
+            return std::apply([](const auto&... items) {
+                uint64_t h = kSecret0;
+                ((h = mix(h ^ Hash<std::decay_t<decltype(items)>>{}(items),
+                    kSecret1)), ...);
+                return h;
+            }, value);
+        } else if constexpr (kHasStdHash<T>) {
+            return std::hash<T>{}(value);
+        } else {
+            static_assert(std::has_unique_object_representations_v<T>,
+                "hashing::Hash: provide std::hash or a custom Hasher");
+            return hashBytes(&value, sizeof(T));
+        }
+    }
+};
+
+}  // namespace hashing
@@ -2,13 +2,30 @@
 #pragma once
 
 #include <gmpxx.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
 #include <iostream>
+#include <limits>
 #include <fstream>
+#include <memory>
+#include <new>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <random>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
-#include "../include/DL_List.hpp"
+#include "../include/BlockedBloomFilter.hpp"
+#include "../include/HashFunctions.hpp"
+#include "../include/NodePool.hpp"
 
 
 template <typename Key, typename Value>
@@ -33,22 +50,332 @@ struct Pair {
     }
 };
 
-template <typename Key, typename Value>
-struct Bucket {
-    DL_list<Pair<Key, Value>> values;
+// Политика хеширования HashTable, которая была единственной до
+// появления параметра Hasher: (a * key + b) mod p в mpz_class для
+// любых ключей, приводимых к mpz_class (целые до 64 бит считаются
+// без GMP по модулю 2^61 - 1, как и раньше).
+struct GmpHash {};
+
+template <typename Hasher>
+inline constexpr bool kIsGmpHash = std::is_same_v<Hasher, GmpHash>;
+
+// mpz_class со стандартным Hasher: знак и лимбы числа
+namespace hashing {
+template <>
+struct Hash<mpz_class> {
+    uint64_t operator()(const mpz_class& value) const {
+        mpz_srcptr z = value.get_mpz_t();
+        return hashBytes(mpz_limbs_read(z), mpz_size(z) * sizeof(mp_limb_t),
+            static_cast<uint64_t>(mpz_sgn(z)));
+    }
+};
+}  // namespace hashing
+
+// Полный 64-битный хеш хранится рядом с парой, если его дорого
+// считать заново: всегда, кроме целых и (со стандартным Hasher)
+// float/double — им хватает пары умножений по модулю 2^61 - 1.
+// Несовпадение хеша отсекает пару до сравнения ключей, а перенос
+// корзин при росте не пересчитывает хеши.
+template <typename Key, typename Hasher = hashing::Hash<Key>>
+inline constexpr bool kBucketCachesHash =
+    !(std::is_integral_v<Key> && sizeof(Key) <= 8)
+    && !(std::is_floating_point_v<Key> && sizeof(Key) <= 8
+        && std::is_same_v<Hasher, hashing::Hash<Key>>);
+
+// место под одну пару во встроенных ячейках (с хешем, если он хранится)
+template <typename Key, typename Value, bool CacheHash>
+inline constexpr size_t kBucketSlotBytes = sizeof(Pair<Key, Value>)
+    + (CacheHash ? sizeof(uint64_t) : 0);
+
+// встроенных ячеек столько, чтобы корзина из счётчика, ячеек и
+// указателя на цепочку занимала одну кэш-линию (но хотя бы одна)
+template <typename Key, typename Value, bool CacheHash>
+inline constexpr int kBucketInlineSlots = std::clamp<int>(static_cast<int>(
+    (64 - sizeof(uint32_t) - sizeof(void*))
+        / kBucketSlotBytes<Key, Value, CacheHash>), 1, 8);
+
+// корзины, помещающиеся в кэш-линию, выравниваются по ней
+template <typename Key, typename Value, bool CacheHash>
+inline constexpr size_t kBucketAlign = kBucketSlotBytes<Key, Value, CacheHash>
+        <= 64 - sizeof(uint32_t) - sizeof(void*)
+    ? 64 : std::max(alignof(Pair<Key, Value>), alignof(void*));
+
+// Корзина: первые kInlineSlots пар лежат прямо в массиве корзин
+// (для небольших пар вся корзина — одна кэш-линия), остальные —
+// в односвязной цепочке переполнения. Цепочка непуста, только когда
+// встроенные ячейки заняты, так что обычно поиск не выходит за
+// пределы корзины.
+//
+// Операции получают полный хеш ключа; при CacheHash он хранится
+// у каждой пары и сравнивается раньше ключа.
+//
+// Узлы цепочки выделяет распределитель таблицы: он передаётся в
+// операции, а не хранится в каждой корзине. Нулевые байты —
+// корректная пустая корзина. Конструктор и деструктор тривиальны,
+// поэтому calloc сам создаёт объекты корзин (implicit-lifetime тип):
+// HashTable берёт массив корзин из calloc, ничего не конструируя,
+// и сама очищает корзины через clear().
+template <typename Key, typename Value,
+          bool CacheHash = kBucketCachesHash<Key>>
+struct alignas(kBucketAlign<Key, Value, CacheHash>) Bucket {
+    using Entry = Pair<Key, Value>;
+
+    static constexpr int kInlineSlots =
+        kBucketInlineSlots<Key, Value, CacheHash>;
+
+    // пустое место вместо хеша, когда он не хранится
+    struct NoHash {
+        NoHash() = default;
+        explicit NoHash(uint64_t) {}
+    };
+    using StoredHash = std::conditional_t<CacheHash, uint64_t, NoHash>;
+
+    // пустой «массив» хешей встроенных ячеек
+    struct NoHashes {
+        NoHash operator[](uint32_t) const {
+            return NoHash();
+        }
+    };
+
+    // узел цепочки переполнения
+    struct Node {
+        Entry entry;
+        Node* next;
+        [[no_unique_address]] StoredHash hash;
+
+        template <typename E>
+        Node(E&& e, Node* n, uint64_t h)
+            : entry(std::forward<E>(e)), next(n), hash(h) {}
+    };
+
+    Bucket() = default;
+    Bucket(const Bucket&) = delete;
+    Bucket& operator=(const Bucket&) = delete;
+
+    Entry* find(const Key& key, uint64_t hash) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (matches(hashes[i], hash) && slot(i)->key == key) {
+                return slot(i);
+            }
+        }
+        for (Node* node = overflow; node; node = node->next) {
+            if (matches(node->hash, hash) && node->entry.key == key) {
+                return &node->entry;
+            }
+        }
+        return nullptr;
+    }
+
+    // ключа в корзине быть не должно
+    template <typename E, typename Alloc>
+    void push(E&& entry, uint64_t hash, Alloc& alloc) {
+        if (count < kInlineSlots) {
+            new (slots + count * sizeof(Entry)) Entry(std::forward<E>(entry));
+            hashes[count] = StoredHash(hash);
+            count++;
+        } else {
+            overflow = createNode(std::forward<E>(entry), overflow, hash,
+                alloc);
+        }
+    }
+
+    // вынимает значение ключа за один проход по корзине
+    template <typename Alloc>
+    std::optional<Value> take(const Key& key, uint64_t hash, Alloc& alloc) {
+        for (uint32_t i = 0; i < count; i++) {
+            if (matches(hashes[i], hash) && slot(i)->key == key) {
+                std::optional<Value> value(std::move(slot(i)->value));
+                eraseSlot(i, alloc);
+                return value;
+            }
+        }
+        for (Node** link = &overflow; *link; link = &(*link)->next) {
+            Node* node = *link;
+            if (matches(node->hash, hash) && node->entry.key == key) {
+                std::optional<Value> value(std::move(node->entry.value));
+                *link = node->next;
+                destroyNode(node, alloc);
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Переносит все пары в table[hash % capacity]; узлы переполнения
+    // перецепляются без копирования, если там нет места во встроенных.
+    // hashOf нужен, только если хеши не хранятся.
+    template <typename HashFn, typename Alloc>
+    void drainInto(Bucket* table, int capacity, HashFn&& hashOf,
+                   Alloc& alloc) {
+        auto target = [&](uint64_t hash) -> Bucket& {
+            return table[hash % static_cast<uint64_t>(capacity)];
+        };
+
+        for (uint32_t i = 0; i < count; i++) {
+            uint64_t hash = hashAt(hashes[i], slot(i)->key, hashOf);
+            target(hash).push(std::move(*slot(i)), hash, alloc);
+            slot(i)->~Entry();
+        }
+        count = 0;
+
+        while (Node* node = overflow) {
+            overflow = node->next;
+            uint64_t hash = hashAt(node->hash, node->entry.key, hashOf);
+            Bucket& to = target(hash);
+            if (to.count < kInlineSlots) {
+                to.push(std::move(node->entry), hash, alloc);
+                destroyNode(node, alloc);
+            } else {
+                node->next = to.overflow;
+                to.overflow = node;
+            }
+        }
+    }
+
+    // копирует пары other вместе с хешами в пустую корзину
+    template <typename Alloc>
+    void copyFrom(const Bucket& other, Alloc& alloc) {
+        for (uint32_t i = 0; i < other.count; i++) {
+            new (slots + i * sizeof(Entry)) Entry(*other.slot(i));
+            hashes[i] = other.hashes[i];
+            count++;
+        }
+        Node** tail = &overflow;
+        for (Node* node = other.overflow; node; node = node->next) {
+            *tail = createNode(node->entry, nullptr, storedValue(node->hash),
+                alloc);
+            tail = &(*tail)->next;
+        }
+    }
+
+    template <typename F>
+    void forEach(F&& f) const {
+        for (uint32_t i = 0; i < count; i++) {
+            f(*slot(i));
+        }
+        for (Node* node = overflow; node; node = node->next) {
+            f(node->entry);
+        }
+    }
+
+    // полные хеши пар: хранимые или, если их нет, от hashOf
+    template <typename F, typename HashFn>
+    void forEachHash(F&& f, HashFn&& hashOf) const {
+        for (uint32_t i = 0; i < count; i++) {
+            f(hashAt(hashes[i], slot(i)->key, hashOf));
+        }
+        for (Node* node = overflow; node; node = node->next) {
+            f(hashAt(node->hash, node->entry.key, hashOf));
+        }
+    }
+
+    template <typename Alloc>
+    void clear(Alloc& alloc) {
+        for (uint32_t i = 0; i < count; i++) {
+            slot(i)->~Entry();
+        }
+        count = 0;
+        while (Node* node = overflow) {
+            overflow = node->next;
+            destroyNode(node, alloc);
+        }
+    }
+
+ private:
+    uint32_t count;  // занятые встроенные ячейки
+    [[no_unique_address]] std::conditional_t<CacheHash,
+        uint64_t[kInlineSlots], NoHashes> hashes;
+    alignas(Entry) unsigned char slots[kInlineSlots * sizeof(Entry)];
+    Node* overflow;  // голова цепочки переполнения
+
+    Entry* slot(uint32_t i) {
+        return std::launder(reinterpret_cast<Entry*>(slots) + i);
+    }
+
+    const Entry* slot(uint32_t i) const {
+        return std::launder(reinterpret_cast<const Entry*>(slots) + i);
+    }
+
+    static bool matches(StoredHash stored, uint64_t hash) {
+        if constexpr (CacheHash) {
+            return stored == hash;
+        } else {
+            return true;
+        }
+    }
+
+    static uint64_t storedValue(StoredHash stored) {
+        if constexpr (CacheHash) {
+            return stored;
+        } else {
+            return 0;
+        }
+    }
+
+    template <typename HashFn>
+    static uint64_t hashAt(StoredHash stored, const Key& key,
+                           HashFn& hashOf) {
+        if constexpr (CacheHash) {
+            return stored;
+        } else {
+            return hashOf(key);
+        }
+    }
+
+    template <typename E, typename Alloc>
+    static Node* createNode(E&& entry, Node* next, uint64_t hash,
+                            Alloc& alloc) {
+        using Traits = std::allocator_traits<Alloc>;
+        Node* node = Traits::allocate(alloc, 1);
+        try {
+            Traits::construct(alloc, node, std::forward<E>(entry), next, hash);
+        } catch (...) {
+            Traits::deallocate(alloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    template <typename Alloc>
+    static void destroyNode(Node* node, Alloc& alloc) {
+        using Traits = std::allocator_traits<Alloc>;
+        Traits::destroy(alloc, node);
+        Traits::deallocate(alloc, node, 1);
+    }
+
+    // дыру закрывает последняя встроенная пара, а её место — голова
+    // цепочки переполнения
+    template <typename Alloc>
+    void eraseSlot(uint32_t i, Alloc& alloc) {
+        uint32_t last = count - 1;
+        if (i != last) {
+            *slot(i) = std::move(*slot(last));
+            hashes[i] = hashes[last];
+        }
+        if (Node* head = overflow) {
+            *slot(last) = std::move(head->entry);
+            hashes[last] = head->hash;
+            overflow = head->next;
+            destroyNode(head, alloc);
+        } else {
+            slot(last)->~Entry();
+            count--;
+        }
+    }
 };
 
 // Хелпер-класс для безопасного управления gmp_randstate_t
 class GmpStateWrapper {
  public:
-    // 1. Конструктор: Инициализирует ресурс
-    GmpStateWrapper() {
-        gmp_randinit_default(state_);
-    }
+    // 1. Конструктор: ресурс инициализируется лениво, при первом
+    // get_state(), — таблицам в режиме HashSetup::Fast он не нужен
+    GmpStateWrapper() {}
 
     // 2. Деструктор: Освобождает ресурс
     ~GmpStateWrapper() {
-        gmp_randclear(state_);
+        if (initialized_) {
+            gmp_randclear(state_);
+        }
     }
 
     // 3. Запрещаем копирование (ресурс уникальный)
@@ -56,21 +383,76 @@ class GmpStateWrapper {
     GmpStateWrapper& operator=(const GmpStateWrapper&) = delete;
 
     // 4. Геттер для доступа к gmp_randstate_t извне
-    gmp_randstate_t& get_state() noexcept { return state_; }
-    const gmp_randstate_t& get_state() const noexcept { return state_; }
+    gmp_randstate_t& get_state() noexcept {
+        ensure();
+        return state_;
+    }
+    const gmp_randstate_t& get_state() const noexcept {
+        ensure();
+        return state_;
+    }
 
     // 5. Вспомогательный метод обмена (для использования в HashTable::swap)
     void swap(GmpStateWrapper& other) noexcept {
         // gmp_randstate_t — это C-структура/массив, который можно безопасно
         // обменять побитно, чтобы обменять указатель на ресурс.
         std::swap(state_, other.state_);
+        std::swap(initialized_, other.initialized_);
     }
 
  private:
-    gmp_randstate_t state_;
+    mutable gmp_randstate_t state_;
+    mutable bool initialized_ = false;
+
+    void ensure() const noexcept {
+        if (!initialized_) {
+            gmp_randinit_default(state_);
+            initialized_ = true;
+        }
+    }
 };
 
-template <typename Key, typename Value>
+// Random — a и b из GMP-генератора, p — следующее простое после
+// случайного 64-битного числа (mpz_nextprime); так было всегда.
+// Fast — p из таблицы заранее найденных 64-битных простых, a и b из
+// splitmix64; GMP-генератор не создаётся, конструктор в разы дешевле.
+enum class HashSetup {
+    Random,
+    Fast
+};
+
+// 64-битные простые для HashSetup::Fast (mpz_nextprime от случайных
+// чисел со старшим битом)
+inline constexpr uint64_t kHashTablePrimes[] = {
+    0x9d941fad576fdb4bull, 0xaeb5ec8caefd6e0bull, 0xaae84c75ecb88781ull,
+    0xd7a207d8009cc62bull, 0x96d3a6e71eb4a71bull, 0xc0f7b47df9403777ull,
+    0xed7faa18cfae9619ull, 0x83b390804e203fa7ull, 0xda4ff23b8953ffddull,
+    0xfb24746d2742bd99ull, 0xa5d0fe395bdbc7c3ull, 0xbc543b5b9de1722bull,
+    0x99a9588f0599c55dull, 0xc6cd46ee507f7acbull, 0x87120e34592fdb8bull,
+    0xee553eff61b7a1dfull, 0xbca98570c98b989full, 0xa8b01e5fbed35219ull,
+    0xd85e4a5aed02e1f3ull, 0xd81b381616168069ull, 0x9b69950d870de761ull,
+    0xeb42f64e81072361ull, 0x86fe4b82f60f45b7ull, 0xd79bea05c034d477ull,
+    0xbc4cabadd0771a87ull, 0xb21d51dd0d4a0c8dull, 0xb137b97c7ad53befull,
+    0xc3aac271dbed74d7ull, 0xdfc4c50535f4db11ull, 0x87ff4c70faed607dull,
+    0xe088ee209c251ec7ull, 0xc5812031cf96994bull};
+
+// Hasher сводит ключ к 64 битам, а таблица применяет к ним свой
+// случайный универсальный хеш (a * lo + c * hi + b) mod (2^61 - 1)
+// по 32-битным половинам. Других хешей ключа таблица не считает:
+// фильтр Блума тоже берёт полный хеш. По умолчанию hashing::Hash:
+// целые, float/double, строки, mpz_class, std::pair/std::tuple, типы
+// с std::hash и простые структуры; для прочих ключей хватает своего
+// Hasher. GmpHash — прежнее хеширование через mpz_class для ключей,
+// приводимых к mpz_class.
+//
+// Allocator — откуда берутся узлы цепочек переполнения. По умолчанию
+// у каждой таблицы свой NodePool: узлы выдаются из плит и повторно
+// используются после remove, а clean() освобождает плиты разом.
+// Подойдёт и любой распределитель с конструктором по умолчанию,
+// например std::allocator — тогда каждый узел в обычной куче.
+template <typename Key, typename Value,
+          typename Hasher = hashing::Hash<Key>,
+          typename Allocator = PoolAllocator<Pair<Key, Value>>>
 class HashTable {
  public:
     HashTable()
@@ -84,121 +466,310 @@ class HashTable {
         init();
     }
 
+    HashTable(int cap, HashSetup setup)
+        : buckets(nullptr), loadFactor(0.0f), size(0), capacity(cap) {
+        if (capacity <= 0) capacity = 5;
+        if (setup == HashSetup::Fast) {
+            initFast();
+        } else {
+            init();
+        }
+    }
+
     HashTable(const HashTable& other)
         : buckets(nullptr),
         loadFactor(other.loadFactor),
         size(other.size),
         capacity(other.capacity),
+        maxLoadFactor(other.maxLoadFactor),
         a(other.a),
         b(other.b),
-        p(other.p)  {
-        buckets = new Bucket<Key, Value>[capacity];
+        p(other.p),
+        a61(other.a61),
+        b61(other.b61),
+        c61(other.c61),
+        hasher(other.hasher),
+        bloomRate(other.bloomRate)  {
+        other.finishMigration();
+        if (other.bloom) {
+            bloom = std::make_unique<BlockedBloomFilter>(*other.bloom);
+        }
+        if (!other.buckets) {
+            return;  // после clean() или перемещения копировать нечего
+        }
+        buckets = allocateBuckets(capacity);
 
         for (int i = 0; i < capacity; i++) {
-            auto* node = other.buckets[i].values.getHead();   // или getHead()
-            while (node) {
-                buckets[i].values.addTail(node->value);
-                node = node->next;
-            }
+            buckets[i].copyFrom(other.buckets[i], nodeAlloc);
         }
     }
 
+    // Забирает корзины, пул узлов, параметры хеша и фильтр за O(1), без
+    // выделения памяти. Перемещённая таблица пуста, как после clean();
+    // корзины, пул и параметры хеша она получит при следующей вставке.
+    HashTable(HashTable&& other) noexcept
+        : buckets(nullptr),
+        loadFactor(0.0f),
+        size(0),
+        capacity(kDefaultCapacity),
+        pool(nullptr),
+        nodeAlloc(other.nodeAlloc) {
+        swap(other);
+    }
+
     HashTable& operator=(const HashTable& other) {
         if (this != &other) {
-            HashTable<Key, Value> tmp(other);  // Глубокая копия
+            HashTable tmp(other);  // Глубокая копия
             swap(tmp);
         }
 
         return *this;
     }
 
+    HashTable& operator=(HashTable&& other) noexcept {
+        if (this != &other) {
+            HashTable tmp(std::move(other));
+            swap(tmp);  // прежнее содержимое уходит с tmp
+        }
+
+        return *this;
+    }
+
     ~HashTable() {
         clean();
         // gmp_randclear(state);
     }
 
 
+    // обмен содержимым за O(1): корзины, пулы и параметры хеша
+    // меняются местами, пары не копируются
+    void swap(HashTable& other) noexcept {
+        std::swap(buckets, other.buckets);
+        std::swap(loadFactor, other.loadFactor);
+        std::swap(size, other.size);
+        std::swap(capacity, other.capacity);
+
+        std::swap(a, other.a);
+        std::swap(b, other.b);
+        std::swap(p, other.p);
+        std::swap(a61, other.a61);
+        std::swap(b61, other.b61);
+        std::swap(c61, other.c61);
+        std::swap(hasher, other.hasher);
+        std::swap(oldBuckets, other.oldBuckets);
+        std::swap(oldCapacity, other.oldCapacity);
+        std::swap(migrateIndex, other.migrateIndex);
+        std::swap(maxLoadFactor, other.maxLoadFactor);
+        std::swap(pool, other.pool);
+        std::swap(nodeAlloc, other.nodeAlloc);
+
+        state_wrapper.swap(other.state_wrapper);
+        std::swap(bloom, other.bloom);
+        std::swap(bloomRate, other.bloomRate);
+    }
+
+    friend void swap(HashTable& lhs, HashTable& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+
+    // Номер корзины ключа: (a * lo + c * hi + b) mod (2^61 - 1) по
+    // половинам Hasher(key) через 128-битное умножение, по модулю
+    // ёмкости. С GmpHash нецелые ключи (и ключи шире 64 бит) идут через
+    // mpz_class, как раньше.
     int hashing(const Key& key) const {
-        mpz_class key_mpz = key;
-        mpz_class hash = ((a * key_mpz + b) % p) % capacity;
-        return static_cast<int>(hash.get_ui());
+        return indexFor(key, capacity);
     }
 
 
+    // Когда size / capacity превышает maxLoadFactor, таблица
+    // удваивается, но корзины переносятся постепенно: каждая операция
+    // перецепляет узлы нескольких старых корзин, так что долгой
+    // перестройки на одной вставке нет.
     void insert(const Key& key, const Value& value) {
-        int index = hashing(key);
-        if (searchPairByKey(buckets[index].values, key) == -1) {
-            buckets[index].values.addTail(Pair<Key, Value>(key, value));
-            size++;
-            loadFactor = static_cast<float>(size) / capacity;
-        } else {
+        ensureStorage();
+        migrateStep();
+        uint64_t hash = fullHash(key);
+        if (locate(key, hash)) {
             //  std::cerr << "Error, key " << key
             //    << " is already in the table!" << std::endl;
+            return;
+        }
+
+        buckets[hash % capacity].push(Pair<Key, Value>(key, value), hash,
+            nodeAlloc);
+        size++;
+        loadFactor = static_cast<float>(size) / capacity;
+        if (bloom) {
+            bloom->add(bloomHash(hash));
+            if (bloom->needsRebuild()) {
+                rebuildBloomFilter();
+            }
+        }
+        if (loadFactor > maxLoadFactor) {
+            grow();
         }
     }
 
 
-    void remove(const Key& key) {
-        if (!isPresent(key)) {
+    // Один хеш и один проход по корзине: найденный узел отцепляется
+    // напрямую. Возвращает удалённое значение или nullopt, если ключа
+    // не было.
+    std::optional<Value> remove(const Key& key) {
+        if (!buckets) return std::nullopt;
+        uint64_t hash = fullHash(key);
+        if (bloom && !bloom->mayContain(bloomHash(hash))) return std::nullopt;
+
+        migrateStep();
+        std::optional<Value> removed = buckets[hash % capacity].take(key,
+            hash, nodeAlloc);
+        if (!removed) {
+            if (auto* old = oldBucketFor(hash)) {
+                removed = old->take(key, hash, nodeAlloc);
+            }
+        }
+        if (!removed) {
             //  std::cerr << "Error, key " << key
             //    << " is not present in table!" << std::endl;
-            return;
+            return std::nullopt;
         }
 
-        int index = hashing(key);
-
-        Value val = find(key);
-
-        buckets[index].values.removeByValue(Pair<Key, Value>(key, val));
-
         size--;
         loadFactor = static_cast<float>(size) / capacity;
+        if (bloom) {
+            bloom->noteRemoval();
+            if (bloom->needsRebuild()) {
+                rebuildBloomFilter();
+            }
+        }
+        return removed;
     }
 
 
     // и для большей устойчивости можно чуть подстраховать isPresent:
     bool isPresent(const Key& key) {
         if (!buckets) return false;  // защитная проверка — на всякий случай
-        int index = hashing(key);
-        return searchPairByKey(buckets[index].values, key) != -1;
+        uint64_t hash = fullHash(key);
+        if (bloom && !bloom->mayContain(bloomHash(hash))) return false;
+        migrateStep();
+        return locate(key, hash) != nullptr;
     }
 
 
     Value find(const Key& key) {
-        int index = hashing(key);
-        auto* cur = buckets[index].values.getHead();
+        uint64_t hash = fullHash(key);
+        if (bloom && !bloom->mayContain(bloomHash(hash))) return Value();
+        migrateStep();
+        const Pair<Key, Value>* pair = locate(key, hash);
+        return pair ? pair->value : Value();
+    }
 
-        while (cur) {
-            if (cur->value.key == key) {
-                return cur->value.value;
-            }
-            cur = cur->next;
+
+    // Ёмкость не меньше n / maxLoadFactor, чтобы n ключей поместились
+    // без роста. Перестройка выполняется сразу, не постепенно. Если
+    // корзин нет (после clean() или перемещения), ёмкость только
+    // запоминается: с ней корзины создаст первая вставка.
+    void reserve(size_t n) {
+        int needed = capacityFor(n);
+        if (needed > capacity) {
+            rebuild(needed);
         }
-        return Value();
     }
 
 
-    void clean() {
-        if (buckets) {
-            delete[] buckets;
-            buckets = nullptr;  // ← не выделяем новую память!
+    // Наименьшая ёмкость, при которой текущие ключи не превышают
+    // maxLoadFactor (но не меньше ёмкости по умолчанию). Тоже сразу.
+    void shrink_to_fit() {
+        int needed = std::max(capacityFor(size), kDefaultCapacity);
+        if (needed < capacity) {
+            rebuild(needed);
+        }
+    }
+
+
+    // порог size / capacity, после которого таблица удваивается
+    void setMaxLoadFactor(float factor) {
+        if (!(factor > 0.0f)) {
+            throw std::invalid_argument("Max load factor must be positive");
         }
+        maxLoadFactor = factor;
+    }
+
+
+    float getMaxLoadFactor() const {
+        return maxLoadFactor;
+    }
+
+
+    size_t getSize() const {
+        return size;
+    }
+
+
+    int getCapacity() const {
+        return capacity;
+    }
+
+
+    float getLoadFactor() const {
+        return loadFactor;
+    }
+
+
+    // пул узлов таблицы; nullptr, если Allocator — не PoolAllocator
+    const NodePool* getNodePool() const {
+        return pool.get();
+    }
+
+
+    // идёт ли сейчас постепенный перенос из старых корзин
+    bool isRehashing() const {
+        return oldBuckets != nullptr;
+    }
+
+
+    // с пулом узлов освобождает плиты разом; корзины обходятся,
+    // только если у пар есть деструкторы
+    void clean() {
+        releaseStorage();  // ← не выделяем новую память!
         size = 0;
         loadFactor = 0.0f;
+        if (bloom) bloom->clear();
+    }
+
+
+    // Необязательный блочный фильтр Блума перед таблицей: промах
+    // отсекается одной проверкой кэш-линии по уже посчитанному хешу,
+    // без обхода цепочки. Обновляется при insert; после удалений или при
+    // переполнении перестраивается по содержимому таблицы.
+    void enableBloomFilter(size_t expectedKeys,
+                           double falsePositiveRate = 0.01) {
+        bloomRate = falsePositiveRate;
+        bloom = std::make_unique<BlockedBloomFilter>(
+            std::max(expectedKeys, size), falsePositiveRate);
+        fillBloomFilter();
+    }
+
+    void disableBloomFilter() {
+        bloom.reset();
+    }
+
+    const BlockedBloomFilter* getBloomFilter() const {
+        return bloom.get();
     }
 
     void print() const {
-        for (int i = 0; i < capacity; i++) {
+        finishMigration();
+        for (int i = 0; buckets && i < capacity; i++) {
             std::cout << "[" << i << "]: ";
 
-            auto* node = buckets[i].values.getHead();
             std::cout << "[";
-            while (node) {
-                std::cout << "(" << node->value.key << ":"
-                    << node->value.value << ")";
-                if (node->next) std::cout << " <-> ";
-                node = node->next;
-            }
+            bool first = true;
+            buckets[i].forEach([&](const Pair<Key, Value>& pair) {
+                if (!first) std::cout << " <-> ";
+                std::cout << "(" << pair.key << ":" << pair.value << ")";
+                first = false;
+            });
             std::cout << "]\n";
         }
     }
@@ -210,6 +781,8 @@ class HashTable {
             throw std::runtime_error("Cannot open file for writing");
         }
 
+        finishMigration();
+
         // сохраняем метаданные
         file << size << " " << capacity << "\n";
         file << a.get_str() << "\n";
@@ -217,12 +790,10 @@ class HashTable {
         file << p.get_str() << "\n";
 
         // сохраняем все пары key-value
-        for (int i = 0; i < capacity; i++) {
-            auto* node = buckets[i].values.getHead();
-            while (node) {
-                file << node->value.key << " " << node->value.value << "\n";
-                node = node->next;
-            }
+        for (int i = 0; buckets && i < capacity; i++) {
+            buckets[i].forEach([&](const Pair<Key, Value>& pair) {
+                file << pair.key << " " << pair.value << "\n";
+            });
         }
         file.close();
     }
@@ -234,9 +805,8 @@ class HashTable {
         }
 
         // очищаем старые данные
-        if (buckets) {
-            delete[] buckets;
-        }
+        releaseStorage();
+        if (bloom) bloom->clear();
 
         // читаем метаданные
         size_t newSize;
@@ -252,11 +822,12 @@ class HashTable {
         a = mpz_class(aStr);
         b = mpz_class(bStr);
         p = mpz_class(pStr);
+        deriveNativeParams();
 
         capacity = newCapacity;
         size = 0;
         loadFactor = 0.0f;
-        buckets = new Bucket<Key, Value>[capacity];
+        ensureStorage();
 
         // читаем и вставляем пары
         for (size_t i = 0; i < newSize; ++i) {
@@ -275,6 +846,8 @@ class HashTable {
             throw std::runtime_error("Cannot open file for writing");
         }
 
+        finishMigration();
+
         // сохраняем size и capacity
         file.write(reinterpret_cast<const char*>(&size), sizeof(size));
         file.write(reinterpret_cast<const char*>(&capacity), sizeof(capacity));
@@ -298,15 +871,13 @@ class HashTable {
         file.write(pStr.c_str(), pLen);
 
         // сохраняем все пары
-        for (int i = 0; i < capacity; i++) {
-            auto* node = buckets[i].values.getHead();
-            while (node) {
-                file.write(reinterpret_cast<const char*>(&node->value.key)
+        for (int i = 0; buckets && i < capacity; i++) {
+            buckets[i].forEach([&](const Pair<Key, Value>& pair) {
+                file.write(reinterpret_cast<const char*>(&pair.key)
                     , sizeof(Key));
-                file.write(reinterpret_cast<const char*>(&node->value.value)
+                file.write(reinterpret_cast<const char*>(&pair.value)
                     , sizeof(Value));
-                node = node->next;
-            }
+            });
         }
         file.close();
     }
@@ -318,9 +889,8 @@ class HashTable {
         }
 
         // очищаем старые данные
-        if (buckets) {
-            delete[] buckets;
-        }
+        releaseStorage();
+        if (bloom) bloom->clear();
 
         // метаданные
         size_t newSize;
@@ -353,11 +923,12 @@ class HashTable {
         delete[] aBuffer;
         delete[] bBuffer;
         delete[] pBuffer;
+        deriveNativeParams();
 
         capacity = newCapacity;
         size = 0;
         loadFactor = 0.0f;
-        buckets = new Bucket<Key, Value>[capacity];
+        ensureStorage();
 
         // Читаем и вставляем пары
         for (size_t i = 0; i < newSize; ++i) {
@@ -372,15 +943,88 @@ class HashTable {
 
 
  private:
-    Bucket<Key, Value>* buckets;
+    using TableBucket = Bucket<Key, Value, kBucketCachesHash<Key, Hasher>>;
+
+    static constexpr int kDefaultCapacity = 5;
+    // сколько старых корзин переносит одна операция; перенос
+    // заканчивается задолго до следующего удвоения
+    static constexpr int kMigrationSlice = 8;
+    // пока на корзину в среднем приходится не больше половины
+    // встроенных ячеек, цепочки переполнения почти не нужны
+    static constexpr float kDefaultMaxLoadFactor = std::max(0.75f,
+        TableBucket::kInlineSlots / 2.0f);
+
+    TableBucket* buckets;
     float loadFactor;
     size_t size;
     int capacity;
 
+    // корзины до роста: nullptr, если переноса нет; корзины с номером
+    // меньше migrateIndex уже пусты
+    mutable TableBucket* oldBuckets = nullptr;
+    mutable int oldCapacity = 0;
+    mutable int migrateIndex = 0;
+    float maxLoadFactor = kDefaultMaxLoadFactor;
+
+    using NodeAllocator = typename std::allocator_traits<Allocator>
+        ::template rebind_alloc<typename TableBucket::Node>;
+
+    // свой пул есть только у таблиц с PoolAllocator; он в куче, чтобы
+    // адрес не менялся при swap. Распределитель mutable: перенос корзин
+    // идёт и из const-методов
+    std::unique_ptr<NodePool> pool = makePool();
+    mutable NodeAllocator nodeAlloc =
+        makeNodeAllocator(pool.get());
+
     mpz_class a, b, p;
     // gmp_randstate_t state;
     GmpStateWrapper state_wrapper;
 
+    // a и b по модулю 2^61 - 1 для хеширования без GMP и множитель
+    // старших 32 бит ключа; выводятся из a и b, поэтому форматы файлов
+    // не меняются
+    uint64_t a61 = 1;
+    uint64_t b61 = 0;
+    uint64_t c61 = 1;
+
+    [[no_unique_address]] Hasher hasher;
+
+    // nullptr — фильтр выключен
+    std::unique_ptr<BlockedBloomFilter> bloom;
+    double bloomRate = 0.01;
+
+    // Хеш для фильтра — перемешанный полный хеш: ключ хешируется один
+    // раз и только через Hasher. Параметры хеша меняются лишь при
+    // загрузке, а она очищает фильтр.
+    static uint64_t bloomHash(uint64_t hash) {
+        return hashing::mix(hash, hashing::kSecret1);
+    }
+
+    // Обходит и новые, и ещё не перенесённые старые корзины: перенос
+    // не форсируется, а хеши берутся из корзин (пересчитываются только
+    // дешёвые, которые там не хранятся).
+    void fillBloomFilter() {
+        auto add = [&](uint64_t hash) { bloom->add(bloomHash(hash)); };
+        auto hashOf = [this](const Key& key) { return fullHash(key); };
+        for (int i = 0; buckets && i < capacity; i++) {
+            buckets[i].forEachHash(add, hashOf);
+        }
+        for (int i = migrateIndex; oldBuckets && i < oldCapacity; i++) {
+            oldBuckets[i].forEachHash(add, hashOf);
+        }
+    }
+
+    // новый фильтр по текущим ключам; если ключей стало больше
+    // расчётного, он рассчитывается на вдвое большее число
+    void rebuildBloomFilter() {
+        size_t expectedKeys = bloom->getExpected();
+        if (size > expectedKeys) {
+            expectedKeys = size * 2;
+        }
+        bloom = std::make_unique<BlockedBloomFilter>(expectedKeys, bloomRate);
+        fillBloomFilter();
+    }
+
     mpz_class get_random_64() {
         mpz_class r;
         // mpz_urandomb(r.get_mpz_t(), state, 64);
@@ -389,7 +1033,7 @@ class HashTable {
     }
 
     void init() {
-        buckets = new Bucket<Key, Value>[capacity];
+        buckets = allocateBuckets(capacity);
         // gmp_randinit_default(state);
         std::random_device rd;
         mpz_class seed = rd();
@@ -400,18 +1044,243 @@ class HashTable {
         b = get_random_64();
         // p = generate_safe_prime(state, 64);
         p = generate_safe_prime(state_wrapper, 64);  // Используем get_state()
+        deriveNativeParams();
+    }
+
+    // без GMP-генератора и mpz_nextprime: соль из часов и счётчика
+    // экземпляров, a и b из splitmix64, p из таблицы простых
+    void initFast() {
+        static std::atomic<uint64_t> instances{0};
+        uint64_t state = static_cast<uint64_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count())
+            ^ (instances.fetch_add(1, std::memory_order_relaxed)
+                * 0xD1B54A32D192ED03ull);
+
+        uint64_t rawA = hashing::splitmix64(state);
+        uint64_t rawB = hashing::splitmix64(state);
+        uint64_t prime = kHashTablePrimes[hashing::splitmix64(state)
+            % std::size(kHashTablePrimes)];
+
+        if (!buckets) buckets = allocateBuckets(capacity);
+        a = mpz_class(static_cast<unsigned long>(rawA));
+        b = mpz_class(static_cast<unsigned long>(rawB));
+        p = mpz_class(static_cast<unsigned long>(prime));
+        a61 = hashing::reduce61(rawA);
+        b61 = hashing::reduce61(rawB);
+        if (a61 == 0) a61 = 1;
+        deriveHighMultiplier();
+    }
+
+    // После clean() корзин нет, а после перемещения нет ещё пула и
+    // параметров хеша (p == 0): всё это создаётся здесь, при первой
+    // вставке или загрузке.
+    void ensureStorage() {
+        if (buckets) return;
+        if constexpr (kIsPoolAllocator<Allocator>) {
+            if (!pool) {
+                pool = makePool();
+                nodeAlloc = makeNodeAllocator(pool.get());
+            }
+        }
+        if (p == 0) {
+            initFast();
+        } else {
+            buckets = allocateBuckets(capacity);
+        }
+    }
+
+    void deriveNativeParams() {
+        mpz_class m = hashing::kMersenne61;
+        mpz_class ar = a % m;
+        mpz_class br = b % m;
+        a61 = ar.get_ui();
+        b61 = br.get_ui();
+        // множитель 0 превратил бы хеш в константу
+        if (a61 == 0) a61 = 1;
+        deriveHighMultiplier();
+    }
+
+    void deriveHighMultiplier() {
+        uint64_t state = a61 ^ std::rotl(b61, 32);
+        c61 = hashing::reduce61(hashing::splitmix64(state));
+        if (c61 == 0) c61 = 1;
+    }
+
+    // Полный хеш ключа, меньше 2^64; номер корзины — его остаток
+    // от деления на ёмкость. 64 бита ключа делятся на две 32-битные
+    // половины со своими множителями: обе меньше 2^61 - 1, поэтому
+    // разные ключи остаются разными, а не склеиваются по модулю, как
+    // -1 и 7 при reduce61 всего ключа.
+    uint64_t fullHash(const Key& key) const {
+        if constexpr (kIsGmpHash<Hasher>
+                && !(std::is_integral_v<Key> && sizeof(Key) <= 8)) {
+            mpz_class key_mpz = key;
+            mpz_class hash = (a * key_mpz + b) % p;
+            return hash.get_ui();
+        } else {
+            uint64_t x = keyBits(key);
+            return hashing::reduce61(hashing::mulMod61(a61, x & 0xFFFFFFFFull)
+                + hashing::mulMod61(c61, x >> 32) + b61);
+        }
+    }
+
+    uint64_t keyBits(const Key& key) const {
+        if constexpr (kIsGmpHash<Hasher>) {
+            return static_cast<uint64_t>(key);
+        } else {
+            return static_cast<uint64_t>(hasher(key));
+        }
+    }
+
+    int indexFor(const Key& key, int cap) const {
+        return static_cast<int>(fullHash(key) % static_cast<uint64_t>(cap));
+    }
+
+    // пара с ключом или nullptr; пока идёт перенос, ключ может лежать
+    // в ещё не перенесённой старой корзине
+    Pair<Key, Value>* locate(const Key& key, uint64_t hash) const {
+        if (!buckets) return nullptr;
+        if (auto* pair = buckets[hash % capacity].find(key, hash)) return pair;
+        if (auto* old = oldBucketFor(hash)) return old->find(key, hash);
+        return nullptr;
+    }
+
+    TableBucket* oldBucketFor(uint64_t hash) const {
+        if (!oldBuckets) return nullptr;
+        int oldIndex = static_cast<int>(hash % oldCapacity);
+        return oldIndex >= migrateIndex ? &oldBuckets[oldIndex] : nullptr;
+    }
+
+    int capacityFor(size_t n) const {
+        double needed = std::ceil(static_cast<double>(n) / maxLoadFactor);
+        return static_cast<int>(std::min<double>(needed,
+            std::numeric_limits<int>::max() / 2));
+    }
+
+    static std::unique_ptr<NodePool> makePool() {
+        if constexpr (kIsPoolAllocator<Allocator>) {
+            return std::make_unique<NodePool>();
+        } else {
+            return nullptr;
+        }
     }
 
-    int searchPairByKey
-        (DL_list<Pair<Key, Value>>& list, const Key& key) {
-        auto* cur = list.getHead();
-        int idx = 0;
-        while (cur) {
-            if (cur->value.key == key) return idx;
-            cur = cur->next;
-            idx++;
+    static NodeAllocator makeNodeAllocator(NodePool* nodePool) {
+        if constexpr (kIsPoolAllocator<Allocator>) {
+            return NodeAllocator(*nodePool);
+        } else {
+            return NodeAllocator();
+        }
+    }
+
+    // Пустая корзина — нулевые байты, поэтому массив корзин берётся
+    // из calloc: большие массивы приходят из mmap уже обнулёнными,
+    // и рост не платит за заполнение всей новой таблицы разом —
+    // страницы обнуляются при первом обращении. Память берётся с
+    // запасом на выравнивание корзин; исходный указатель лежит прямо
+    // перед массивом.
+    static TableBucket* allocateBuckets(int count) {
+        // без тривиальных конструктора и деструктора calloc не создаст
+        // объекты корзин, и обращение к ним было бы UB
+        static_assert(std::is_trivially_default_constructible_v<TableBucket>
+            && std::is_trivially_destructible_v<TableBucket>,
+            "Bucket must be an implicit-lifetime type");
+        constexpr size_t align = alignof(TableBucket);
+        size_t bytes = static_cast<size_t>(count) * sizeof(TableBucket)
+            + sizeof(void*) + align - 1;
+        void* memory = std::calloc(1, bytes);
+        if (!memory) {
+            throw std::bad_alloc();
+        }
+
+        uintptr_t start = reinterpret_cast<uintptr_t>(memory) + sizeof(void*);
+        start = (start + align - 1) & ~static_cast<uintptr_t>(align - 1);
+        reinterpret_cast<void**>(start)[-1] = memory;
+        return reinterpret_cast<TableBucket*>(start);
+    }
+
+    // память массива без обхода корзин: все они должны быть пусты
+    static void freeBuckets(TableBucket* array) {
+        if (array) {
+            std::free(reinterpret_cast<void**>(array)[-1]);
+        }
+    }
+
+    void releaseBuckets(TableBucket* array, int count) {
+        if (!array) return;
+        if (!(pool && std::is_trivially_destructible_v<Pair<Key, Value>>)) {
+            for (int i = 0; i < count; i++) {
+                array[i].clear(nodeAlloc);
+            }
+        }
+        freeBuckets(array);
+    }
+
+    // все корзины и узлы; buckets становится nullptr
+    void releaseStorage() {
+        releaseBuckets(buckets, capacity);
+        releaseBuckets(oldBuckets, oldCapacity);
+        buckets = nullptr;
+        oldBuckets = nullptr;
+        oldCapacity = 0;
+        migrateIndex = 0;
+        if (pool) pool->release();
+    }
+
+    // начинаем рост: текущие корзины становятся старыми и переносятся
+    // по kMigrationSlice за операцию
+    void grow() {
+        finishMigration();
+        startResize(capacity * 2);
+    }
+
+    // без корзин ёмкость только запоминается для ensureStorage()
+    void rebuild(int newCapacity) {
+        if (!buckets) {
+            capacity = newCapacity;
+            return;
+        }
+        finishMigration();
+        startResize(newCapacity);
+        finishMigration();
+    }
+
+    void startResize(int newCapacity) {
+        auto* fresh = allocateBuckets(newCapacity);
+        if (size == 0) {
+            freeBuckets(buckets);  // все корзины пусты
+        } else {
+            oldBuckets = buckets;
+            oldCapacity = capacity;
+            migrateIndex = 0;
+        }
+        buckets = fresh;
+        capacity = newCapacity;
+        loadFactor = static_cast<float>(size) / capacity;
+    }
+
+    // перецепляет узлы очередных старых корзин в новые, без копирования
+    void migrateStep(int slice = kMigrationSlice) const {
+        if (!oldBuckets) return;
+
+        int end = std::min(migrateIndex + slice, oldCapacity);
+        for (; migrateIndex < end; migrateIndex++) {
+            oldBuckets[migrateIndex].drainInto(buckets, capacity,
+                [this](const Key& key) { return fullHash(key); }, nodeAlloc);
+        }
+
+        if (migrateIndex == oldCapacity) {
+            freeBuckets(oldBuckets);  // все корзины уже пусты
+            oldBuckets = nullptr;
+            oldCapacity = 0;
+            migrateIndex = 0;
+        }
+    }
+
+    void finishMigration() const {
+        if (oldBuckets) {
+            migrateStep(oldCapacity);
         }
-        return -1;
     }
 
 
@@ -430,17 +1299,4 @@ class HashTable {
         mpz_nextprime(prime.get_mpz_t(), prime.get_mpz_t());
         return prime;
     }
-
-    void swap(HashTable& other) noexcept {
-        std::swap(buckets, other.buckets);
-        std::swap(loadFactor, other.loadFactor);
-        std::swap(size, other.size);
-        std::swap(capacity, other.capacity);
-
-        std::swap(a, other.a);
-        std::swap(b, other.b);
-        std::swap(p, other.p);
-
-        state_wrapper.swap(other.state_wrapper);
-    }
 };
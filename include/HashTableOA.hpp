@@ -1,140 +1,508 @@
 // Copyright message
 #pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <random>
 #include <utility>
 #include <type_traits>
 #include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "../include/HashFunctions.hpp"
 
-template <typename Key, typename Value>
+// Linear — линейное пробирование с надгробиями при удалении.
+// RobinHood — ключ, ушедший дальше от своей ячейки, вытесняет более
+// "богатый"; удаление сдвигает хвост цепочки назад, надгробий нет.
+enum class ProbingPolicy {
+    Linear,
+    RobinHood
+};
+
+// Universal — (a * key + b) % p, затем остаток от деления на ёмкость.
+// Fast — ёмкость округляется до степени двойки, ключ перемешивается
+// 64-битным умножением с солью экземпляра, ячейка берётся маской.
+enum class HashMode {
+    Universal,
+    Fast
+};
+
+// Срез состояния таблицы для наблюдения и автоподстройки размера.
+// Смещения, надгробия и заполнение считаются проходом по таблице в
+// getStats(); гистограмма длины пробирования и неудачные вставки
+// накапливаются только в HashTableOA<..., true>, в остальных таблицах
+// они нулевые и ничего не стоят.
+struct HashTableOAStats {
+    // последняя корзина гистограмм — "столько групп и больше"
+    static constexpr size_t kBuckets = 16;
+
+    size_t size = 0;
+    size_t capacity = 0;
+    size_t tombstones = 0;
+    float loadFactor = 0.0f;
+    // доля надгробий от ёмкости
+    float tombstoneRatio = 0.0f;
+
+    // расстояние ключа от домашней ячейки, в ячейках
+    double averageDisplacement = 0.0;
+    size_t maxDisplacement = 0;
+    // сколько групп по 16 просмотрит успешный поиск каждого ключа:
+    // [0] — одну, [1] — две, ...
+    std::array<uint64_t, kBuckets> displacementGroups = {};
+
+    // сколько групп просмотрели поиски и вставки с момента создания
+    // или resetStats()
+    std::array<uint64_t, kBuckets> probeHistogram = {};
+    uint64_t failedInserts = 0;
+};
+
+// Telemetry = true включает счётчики пробирования (relaxed atomics,
+// можно читать под общим замком); при false их код не компилируется.
+template <typename Key, typename Value, bool Telemetry = false>
 class HashTableOA {
  public:
-    explicit HashTableOA(int capacity)
-        : size(0), capacity(capacity), loadFactor(0.0f), p(1000000007) {
-        table = new Cell[capacity];
+    // Тип ключа для поиска. Для строковых ключей это std::string_view:
+    // find/isPresent/remove принимают std::string, string_view и
+    // строковые литералы без создания временного std::string.
+    using LookupKey = std::conditional_t<
+        std::is_convertible_v<const Key&, std::string_view>,
+        std::string_view, Key>;
+
+    explicit HashTableOA(int capacity,
+                         ProbingPolicy policy = ProbingPolicy::Linear,
+                         HashMode mode = HashMode::Universal)
+        : size(0), loadFactor(0.0f), p(1000000007), policy(policy),
+          mode(mode) {
+        table = allocateTable(roundCapacity(capacity > 0 ? capacity : 0),
+            policy);
         init();
     }
 
+    HashTableOA(int capacity, HashMode mode)
+        : HashTableOA(capacity, ProbingPolicy::Linear, mode) {}
+
     HashTableOA(const HashTableOA& other)
-        : size(other.getSize()),
-          capacity(other.getCapacity()),
-          loadFactor(other.getLoadFactor()),
+        : size(0),
+          loadFactor(0.0f),
           a(other.a),
           b(other.b),
-          p(other.p) {
-            table = new Cell[other.getCapacity()];
-            for (size_t i = 0; i < capacity; i++) {
-                table[i] = other.table[i];
+          p(other.p),
+          policy(other.policy),
+          mode(other.mode),
+          seed(other.seed),
+          maxLoadFactor(other.maxLoadFactor) {
+            // копируем уже полностью перенесённую таблицу
+            other.finishMigration();
+            table = allocateTable(other.getCapacity(), policy);
+            try {
+                for (size_t i = 0; i < table.capacity; i++) {
+                    uint8_t c = other.table.ctrl[i];
+                    if (isFull(c)) {
+                        new (&table.cells[i]) Cell(other.table.cells[i]);
+                    }
+                    if (table.dist) {
+                        table.dist[i] = other.table.dist[i];
+                    }
+                    setCtrl(table, i, c);
+                }
+            } catch (...) {
+                releaseTable(table);
+                throw;
             }
+            size = other.getSize();
+            loadFactor = other.getLoadFactor();
+            deletedCount = other.deletedCount;
+            tombstonePurgeRatio = other.tombstonePurgeRatio;
           }
 
+    // Забирает массивы ячеек (и отображённый снимок) за O(1), без
+    // выделения памяти. Перемещённая таблица пуста, как после clean(),
+    // с теми же параметрами хеша, и снова растёт при вставке.
+    HashTableOA(HashTableOA&& other) noexcept
+        : size(0),
+          loadFactor(0.0f),
+          a(other.a),
+          b(other.b),
+          p(other.p),
+          policy(other.policy),
+          mode(other.mode),
+          seed(other.seed),
+          maxLoadFactor(other.maxLoadFactor) {
+        swap(other);
+    }
+
     HashTableOA& operator=(const HashTableOA& other) {
         if (this != &other) {
-            HashTableOA<Key, Value> tmp(other);
+            HashTableOA tmp(other);
             swap(tmp);
         }
 
         return *this;
     }
 
+    HashTableOA& operator=(HashTableOA&& other) noexcept {
+        if (this != &other) {
+            HashTableOA tmp(std::move(other));
+            swap(tmp);  // прежнее содержимое уходит с tmp
+        }
+
+        return *this;
+    }
+
     ~HashTableOA() {
         clean();
     }
 
+    // обмен содержимым за O(1): массивы и параметры меняются местами,
+    // ячейки не копируются
+    void swap(HashTableOA& other) noexcept {
+        std::swap(table, other.table);
+        std::swap(loadFactor, other.loadFactor);
+        std::swap(size, other.size);
+
+        std::swap(a, other.a);
+        std::swap(b, other.b);
+        std::swap(p, other.p);
+
+        std::swap(policy, other.policy);
+        std::swap(mode, other.mode);
+        std::swap(seed, other.seed);
+        std::swap(maxLoadFactor, other.maxLoadFactor);
+        std::swap(deletedCount, other.deletedCount);
+        std::swap(oldTable, other.oldTable);
+        std::swap(migrateIndex, other.migrateIndex);
+        std::swap(tombstonePurgeRatio, other.tombstonePurgeRatio);
+        if constexpr (Telemetry) {
+            counters.swap(other.counters);
+        }
+    }
+
+    friend void swap(HashTableOA& lhs, HashTableOA& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
     bool insert(const Key& key, const Value& value) {
-        size_t index;
-        for (size_t i = 0; i < capacity; i++) {
-            index = (h1(key) + i) % capacity;
+        return insert_or_assign(key, value).first != nullptr;
+    }
 
-            if (!table[index].isOccupied || table[index].isDeleted) {
-                table[index].key = key;
-                table[index].value = value;
-                table[index].isOccupied = true;
-                table[index].isDeleted = false;
-                size++;
-                loadFactor = getLoadFactor();
-                return true;
-            }
 
-            if (table[index].isOccupied && !table[index].isDeleted
-                    && table[index].key == key) {
-                table[index].value = value;
-                return true;
-            }
+    // Вставка без лишних копий. Все варианты делают один проход
+    // пробирования и возвращают указатель на значение в таблице и
+    // true, если ключ был добавлен, false — если он уже был.
+
+    // если ключа нет — конструирует Value(args...) прямо в ячейке,
+    // если есть — ничего не делает и args не трогает
+    template <typename... Args>
+    std::pair<Value*, bool> try_emplace(const Key& key, Args&&... args) {
+        return emplaceImpl(key, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::pair<Value*, bool> try_emplace(Key&& key, Args&&... args) {
+        return emplaceImpl(std::move(key), std::forward<Args>(args)...);
+    }
+
+    // если ключ есть — присваивает ему obj, иначе вставляет
+    template <typename M>
+    std::pair<Value*, bool> insert_or_assign(const Key& key, M&& obj) {
+        return assignImpl(key, std::forward<M>(obj));
+    }
+
+    template <typename M>
+    std::pair<Value*, bool> insert_or_assign(Key&& key, M&& obj) {
+        return assignImpl(std::move(key), std::forward<M>(obj));
+    }
+
+    // как try_emplace, но ключ может быть любого типа, из которого
+    // строится Key (например, const char* или string_view для строк);
+    // если ключ уже есть, Key не создаётся
+    template <typename K, typename... Args>
+    std::pair<Value*, bool> emplace(K&& key, Args&&... args) {
+        if constexpr (std::is_convertible_v<K&&, LookupKey>) {
+            return emplaceImpl(std::forward<K>(key),
+                std::forward<Args>(args)...);
+        } else {
+            return emplaceImpl(Key(std::forward<K>(key)),
+                std::forward<Args>(args)...);
         }
+    }
+
 
-        std::cerr << "Error: table is full!" << std::endl;
-        return false;
+    bool isPresent(const LookupKey& key) const {
+        migrateStep();
+        return locate(key) != nullptr;
     }
 
 
-    bool isPresent(const Key& key) const {
-        size_t h = h1(key);
+    Value find(const LookupKey& key) const {
+        migrateStep();
+        const Cell* cell = locate(key);
+        if (!cell) {
+            return Value();
+        }
+        return cell->value;
+    }
 
-        for (size_t i = 0; i < capacity; i++) {
-            size_t index = (h + i) % capacity;
-            const Cell& cell = table[index];
 
-            if (!cell.isOccupied && !cell.isDeleted) {
-                return false;
-            }
-            if (cell.isOccupied && !cell.isDeleted && cell.key == key) {
-                return true;
-            }
+    // поиск без копирования значения: указатель на значение в таблице
+    // или nullptr, если ключа нет; действителен до следующей операции
+    // с таблицей (во время роста даже поиск переносит ячейки)
+    const Value* find_ptr(const LookupKey& key) const {
+        migrateStep();
+        const Cell* cell = locate(key);
+        if (!cell) {
+            return nullptr;
+        }
+        return &cell->value;
+    }
+
+
+    Value* find_ptr(const LookupKey& key) {
+        return const_cast<Value*>(std::as_const(*this).find_ptr(key));
+    }
+
+
+    // то же в виде optional: промах отличается от сохранённого Value()
+    std::optional<std::reference_wrapper<const Value>>
+    try_get(const LookupKey& key) const {
+        const Value* value = find_ptr(key);
+        if (!value) {
+            return std::nullopt;
+        }
+        return std::cref(*value);
+    }
+
+
+    std::optional<std::reference_wrapper<Value>>
+    try_get(const LookupKey& key) {
+        Value* value = find_ptr(key);
+        if (!value) {
+            return std::nullopt;
+        }
+        return std::ref(*value);
+    }
+
+
+    // Пакетный поиск: out[i] = указатель на значение keys[i] или nullptr.
+    // Ключи идут группами по kBatchSize: сначала для всей группы
+    // считаются хеши и подгружаются (prefetch) домашние ячейки, потом
+    // группа разрешается, так что промахи кэша перекрываются.
+    // Возвращает число найденных ключей.
+    size_t find_batch(std::span<const Key> keys, std::span<Value*> out) {
+        if (out.size() < keys.size()) {
+            throw std::invalid_argument(
+                "find_batch: output span is too small");
         }
 
-        return false;
+        std::span<const Value*> constOut(
+            const_cast<const Value**>(out.data()), out.size());
+        return std::as_const(*this).find_batch(keys, constOut);
     }
 
 
-    Value find(const Key& key) const {
-        size_t h = h1(key);
+    size_t find_batch(std::span<const Key> keys,
+                      std::span<const Value*> out) const {
+        if (out.size() < keys.size()) {
+            throw std::invalid_argument(
+                "find_batch: output span is too small");
+        }
 
-        for (size_t i = 0; i < capacity; i++) {
-            size_t index = (h + i) % capacity;
+        migrateStep();
 
-            const Cell& cell = table[index];
+        uint64_t hashes[kBatchSize];
+        size_t found = 0;
+        for (size_t start = 0; start < keys.size(); start += kBatchSize) {
+            size_t count = keys.size() - start;
+            if (count > kBatchSize) {
+                count = kBatchSize;
+            }
 
-            if (!cell.isOccupied && !cell.isDeleted) {
-                return Value();
+            for (size_t j = 0; j < count; j++) {
+                hashes[j] = hashValue(keys[start + j]);
+                prefetchHome(hashes[j]);
             }
 
-            if (cell.isOccupied && !cell.isDeleted && cell.key == key) {
-                return cell.value;
+            for (size_t j = 0; j < count; j++) {
+                const Cell* cell = locate(keys[start + j], hashes[j]);
+                out[start + j] = cell ? &cell->value : nullptr;
+                found += cell != nullptr;
             }
         }
 
-        return Value();
+        return found;
+    }
+
+
+    bool remove(const LookupKey& key) {
+        migrateStep();
+        uint64_t hash = hashValue(key);
+
+        size_t index = probe(table, hash, key);
+        if (index != npos && policy == ProbingPolicy::RobinHood) {
+            eraseWithBackwardShift(index);
+        } else if (index != npos) {
+            eraseAt(table, index);
+            deletedCount++;
+        } else if (oldTable.ctrl
+                && (index = probe(oldTable, hash, key)) != npos) {
+            // надгробия в старой таблице исчезнут вместе с ней
+            eraseAt(oldTable, index);
+        } else {
+            return false;
+        }
+
+        size--;
+        loadFactor = getLoadFactor();
+        if (tombstonePurgeRatio > 0.0f && static_cast<float>(deletedCount)
+                > tombstonePurgeRatio * static_cast<float>(table.capacity)) {
+            purgeTombstones();
+        }
+        return true;
+    }
+
+
+    // Перестраивает таблицу в той же ёмкости сразу, без постепенного
+    // переноса: надгробия исчезают, цепочки пробирования укорачиваются.
+    void purgeTombstones() {
+        finishMigration();
+        if (deletedCount == 0) {
+            return;
+        }
+
+        Table fresh = allocateTable(table.capacity, policy);
+        oldTable = table;
+        migrateIndex = 0;
+        table = fresh;
+        deletedCount = 0;
+        finishMigration();
+    }
+
+
+    // Доля надгробий от ёмкости, после которой remove сам вызывает
+    // purgeTombstones(); 0 — не следить (по умолчанию).
+    void setTombstonePurgeRatio(float ratio) {
+        if (ratio < 0.0f || ratio > 1.0f) {
+            throw std::invalid_argument(
+                "Tombstone purge ratio must be in [0, 1]");
+        }
+        tombstonePurgeRatio = ratio;
+    }
+
+
+    float getTombstonePurgeRatio() const {
+        return tombstonePurgeRatio;
     }
 
 
-    bool remove(const Key& key) {
-        size_t index;
-        for (size_t i = 0; i < capacity; i++) {
-            index = (h1(key) + i) % capacity;
-            if (!table[index].isOccupied && !table[index].isDeleted) {
-                return false;
+    // Проходит по всей таблице, O(capacity); на обычные операции
+    // не влияет. Незавершённый перенос доводится до конца.
+    HashTableOAStats getStats() const {
+        finishMigration();
+
+        HashTableOAStats stats;
+        stats.size = size;
+        stats.capacity = table.capacity;
+        stats.tombstones = deletedCount;
+        stats.loadFactor = getLoadFactor();
+        if (table.capacity > 0) {
+            stats.tombstoneRatio = static_cast<float>(deletedCount)
+                / static_cast<float>(table.capacity);
+        }
+
+        size_t totalDisplacement = 0;
+        for (size_t i = 0; i < table.capacity; i++) {
+            if (!isFull(table.ctrl[i])) {
+                continue;
             }
-            if (table[index].isOccupied && table[index].key == key) {
-                table[index].isDeleted = true;
-                table[index].isOccupied = false;
-                size--;
-                loadFactor = getLoadFactor();
-                return true;
+            size_t home = wrap(hashValue(table.cells[i].key), table.capacity);
+            size_t d = i >= home ? i - home : i + table.capacity - home;
+            totalDisplacement += d;
+            if (d > stats.maxDisplacement) {
+                stats.maxDisplacement = d;
             }
+            stats.displacementGroups[histogramBucket(d / kGroupWidth + 1)]++;
+        }
+        if (size > 0) {
+            stats.averageDisplacement =
+                static_cast<double>(totalDisplacement) / size;
+        }
+
+        if constexpr (Telemetry) {
+            for (size_t i = 0; i < HashTableOAStats::kBuckets; i++) {
+                stats.probeHistogram[i] =
+                    counters.probes[i].load(std::memory_order_relaxed);
+            }
+            stats.failedInserts =
+                counters.failedInserts.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+
+    void resetStats() {
+        if constexpr (Telemetry) {
+            counters.reset();
         }
-        return false;
+    }
+
+
+    // порог заполнения (с учётом удалённых ячеек), после которого
+    // таблица начинает расти
+    void setMaxLoadFactor(float factor) {
+        if (factor <= 0.0f || factor > 1.0f) {
+            throw std::invalid_argument("Max load factor must be in (0, 1]");
+        }
+        maxLoadFactor = factor;
+    }
+
+
+    float getMaxLoadFactor() const {
+        return maxLoadFactor;
+    }
+
+
+    ProbingPolicy getProbingPolicy() const {
+        return policy;
+    }
+
+
+    HashMode getHashMode() const {
+        return mode;
+    }
+
+
+    // идёт ли сейчас постепенный перенос из старой таблицы
+    bool isRehashing() const {
+        return oldTable.ctrl != nullptr;
     }
 
 
     void print() const {
-        for (size_t i = 0; i < capacity; i++) {
+        finishMigration();
+        for (size_t i = 0; i < table.capacity; i++) {
             std::cout << "[" << i << "]";
-            if (table[i].isOccupied) {
-                std::cout << " {" << table[i].key
-                    << ": " << table[i].value << "}";
-            } else if (table[i].isDeleted) {
+            if (isFull(table.ctrl[i])) {
+                std::cout << " {" << table.cells[i].key
+                    << ": " << table.cells[i].value << "}";
+            } else if (table.ctrl[i] == kDeleted) {
                 std::cout << "(deleted)";
             }
             std::cout << std::endl;
@@ -142,8 +510,10 @@ class HashTableOA {
     }
 
     void clean() {
-        delete[] table;
-        table = nullptr;
+        releaseTable(table);
+        releaseTable(oldTable);
+        migrateIndex = 0;
+        deletedCount = 0;
         size = 0;
         loadFactor = 0.0f;
     }
@@ -155,16 +525,16 @@ class HashTableOA {
 
 
     size_t getCapacity() const {
-        return capacity;
+        return table.capacity;
     }
 
 
     float getLoadFactor() const {
-        if (capacity == 0) {
+        if (table.capacity == 0) {
             return 0.0f;
         }
 
-        return static_cast<float>(size) / capacity;
+        return static_cast<float>(size) / table.capacity;
     }
 
     // текстовый формат
@@ -174,11 +544,14 @@ class HashTableOA {
             throw std::runtime_error("Cannot open file for writing");
         }
 
-        file << size << " " << capacity << " " << a << " " << b << " " << p << "\n";
+        finishMigration();
+        file << size << " " << table.capacity << " " << a << " " << b
+            << " " << p << "\n";
 
-        for (size_t i = 0; i < capacity; i++) {
-            if (table[i].isOccupied && !table[i].isDeleted) {
-                file << table[i].key << " " << table[i].value << "\n";
+        for (size_t i = 0; i < table.capacity; i++) {
+            if (isFull(table.ctrl[i])) {
+                file << table.cells[i].key << " "
+                    << table.cells[i].value << "\n";
             }
         }
         file.close();
@@ -190,14 +563,13 @@ class HashTableOA {
             throw std::runtime_error("Cannot open file for reading");
         }
 
-        delete[] table;
+        clean();
 
         size_t oldSize;
-        file >> oldSize >> capacity >> a >> b >> p;
+        size_t newCapacity;
+        file >> oldSize >> newCapacity >> a >> b >> p;
 
-        table = new Cell[capacity];
-        size = 0;
-        loadFactor = 0.0f;
+        table = allocateTable(roundCapacity(newCapacity), policy);
 
         for (size_t i = 0; i < oldSize; ++i) {
             Key key;
@@ -216,16 +588,20 @@ class HashTableOA {
             throw std::runtime_error("Cannot open file for writing");
         }
 
+        finishMigration();
         file.write(reinterpret_cast<const char*>(&size), sizeof(size));
-        file.write(reinterpret_cast<const char*>(&capacity), sizeof(capacity));
+        file.write(reinterpret_cast<const char*>(&table.capacity),
+            sizeof(table.capacity));
         file.write(reinterpret_cast<const char*>(&a), sizeof(a));
         file.write(reinterpret_cast<const char*>(&b), sizeof(b));
         file.write(reinterpret_cast<const char*>(&p), sizeof(p));
 
-        for (size_t i = 0; i < capacity; i++) {
-            if (table[i].isOccupied && !table[i].isDeleted) {
-                file.write(reinterpret_cast<const char*>(&table[i].key), sizeof(Key));
-                file.write(reinterpret_cast<const char*>(&table[i].value), sizeof(Value));
+        for (size_t i = 0; i < table.capacity; i++) {
+            if (isFull(table.ctrl[i])) {
+                file.write(reinterpret_cast<const char*>(&table.cells[i].key),
+                    sizeof(Key));
+                file.write(reinterpret_cast<const char*>(&table.cells[i].value),
+                    sizeof(Value));
             }
         }
         file.close();
@@ -237,18 +613,17 @@ class HashTableOA {
             throw std::runtime_error("Cannot open file for reading");
         }
 
-        delete[] table;
+        clean();
 
         size_t oldSize;
+        size_t newCapacity;
         file.read(reinterpret_cast<char*>(&oldSize), sizeof(oldSize));
-        file.read(reinterpret_cast<char*>(&capacity), sizeof(capacity));
+        file.read(reinterpret_cast<char*>(&newCapacity), sizeof(newCapacity));
         file.read(reinterpret_cast<char*>(&a), sizeof(a));
         file.read(reinterpret_cast<char*>(&b), sizeof(b));
         file.read(reinterpret_cast<char*>(&p), sizeof(p));
 
-        table = new Cell[capacity];
-        size = 0;
-        loadFactor = 0.0f;
+        table = allocateTable(roundCapacity(newCapacity), policy);
 
         for (size_t i = 0; i < oldSize; ++i) {
             Key key;
@@ -261,53 +636,880 @@ class HashTableOA {
     }
 
 
+    // Снимок: заголовок с параметрами хеша и ёмкостью, затем как есть
+    // управляющие байты, ячейки и (для RobinHood) расстояния. Ничего не
+    // перехешируется ни при записи, ни при чтении, поэтому только для
+    // тривиально копируемых Key и Value.
+    void saveSnapshot(const std::string& filename) const {
+        static_assert(std::is_trivially_copyable_v<Cell>,
+            "snapshots need trivially copyable Key and Value");
+
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Cannot open file for writing");
+        }
+
+        finishMigration();
+        SnapshotHeader header = makeSnapshotHeader();
+
+        // Ячейки и расстояния идут порциями через буфер, где свободные
+        // ячейки и дыры внутри Cell обнулены: иначе в файл попал бы
+        // мусор из кучи. Сумма считается по записанным байтам, поэтому
+        // заголовок с ней дописывается в конце.
+        const char zeros[kSnapshotAlign] = {};
+        uint64_t sum = snapshotChecksumStart(header, table);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(zeros, header.ctrlOffset - sizeof(header));
+        file.write(reinterpret_cast<const char*>(snapshotCtrl(table)),
+            ctrlBytes(table.capacity));
+        file.write(zeros, header.cellsOffset - header.ctrlOffset
+            - ctrlBytes(table.capacity));
+
+        auto chunk = std::make_unique<char[]>(kSnapshotChunk * sizeof(Cell));
+        for (size_t i = 0; i < table.capacity; i += kSnapshotChunk) {
+            size_t count = std::min(kSnapshotChunk, table.capacity - i);
+            std::memset(chunk.get(), 0, count * sizeof(Cell));
+            for (size_t j = 0; j < count; j++) {
+                const Cell& cell = table.cells[i + j];
+                if (!isFull(table.ctrl[i + j])) {
+                    continue;
+                }
+                char* out = chunk.get() + j * sizeof(Cell);
+                const char* from = reinterpret_cast<const char*>(&cell);
+                std::memcpy(out + (reinterpret_cast<const char*>(&cell.key)
+                    - from), &cell.key, sizeof(Key));
+                std::memcpy(out + (reinterpret_cast<const char*>(&cell.value)
+                    - from), &cell.value, sizeof(Value));
+            }
+            file.write(chunk.get(), count * sizeof(Cell));
+            sum = hashing::hashBytes(chunk.get(), count * sizeof(Cell), sum);
+        }
+        if (table.dist) {
+            file.write(zeros, header.distOffset - header.cellsOffset
+                - table.capacity * sizeof(Cell));
+            uint32_t* dist = reinterpret_cast<uint32_t*>(chunk.get());
+            for (size_t i = 0; i < table.capacity; i += kSnapshotChunk) {
+                size_t count = std::min(kSnapshotChunk, table.capacity - i);
+                for (size_t j = 0; j < count; j++) {
+                    dist[j] = isFull(table.ctrl[i + j])
+                        ? table.dist[i + j] : 0;
+                }
+                file.write(chunk.get(), count * sizeof(uint32_t));
+                sum = hashing::hashBytes(dist, count * sizeof(uint32_t), sum);
+            }
+        }
+        header.checksum = sum;
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!file) {
+            throw std::runtime_error("Cannot write snapshot");
+        }
+        file.close();
+    }
+
+    // Отображает снимок в память (MAP_PRIVATE) и работает прямо по нему:
+    // страницы подгружаются при первом обращении, а изменения остаются
+    // в копиях страниц этого процесса и в файл не попадают. Политика,
+    // режим хеша и соль берутся из снимка. Проверка контрольной суммы
+    // читает файл целиком; verify = false оставляет только ленивую
+    // подгрузку.
+    void loadSnapshot(const std::string& filename, bool verify = true) {
+        static_assert(std::is_trivially_copyable_v<Cell>,
+            "snapshots need trivially copyable Key and Value");
+
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open file for reading");
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0
+            || static_cast<size_t>(st.st_size) < sizeof(SnapshotHeader)) {
+            ::close(fd);
+            throw std::runtime_error("Snapshot is truncated");
+        }
+
+        size_t length = static_cast<size_t>(st.st_size);
+        void* base = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            throw std::runtime_error("Cannot map snapshot");
+        }
+
+        Table mapped;
+        mapped.mapping = base;
+        mapped.mappingLength = length;
+
+        const SnapshotHeader& header =
+            *static_cast<const SnapshotHeader*>(base);
+        const char* error = checkSnapshotHeader(header, length);
+        if (!error) {
+            char* bytes = static_cast<char*>(base);
+            mapped.capacity = header.capacity;
+            mapped.ctrl = reinterpret_cast<uint8_t*>(
+                bytes + header.ctrlOffset);
+            mapped.cells = header.capacity > 0
+                ? reinterpret_cast<Cell*>(bytes + header.cellsOffset)
+                : nullptr;
+            if (header.policy == static_cast<uint8_t>(
+                    ProbingPolicy::RobinHood) && header.capacity > 0) {
+                mapped.dist = reinterpret_cast<uint32_t*>(
+                    bytes + header.distOffset);
+            }
+            if (verify && snapshotChecksum(header, mapped)
+                    != header.checksum) {
+                error = "Snapshot checksum mismatch";
+            }
+        }
+        if (error) {
+            releaseTable(mapped);
+            throw std::runtime_error(error);
+        }
+
+        clean();
+        table = mapped;
+        size = header.size;
+        deletedCount = header.deletedCount;
+        a = header.a;
+        b = header.b;
+        p = header.p;
+        seed = header.seed;
+        policy = static_cast<ProbingPolicy>(header.policy);
+        mode = static_cast<HashMode>(header.mode);
+        maxLoadFactor = header.maxLoadFactor;
+        loadFactor = getLoadFactor();
+    }
+
+
  private:
     struct Cell {
         Key key;
         Value value;
-        bool isOccupied;
-        bool isDeleted;
+    };
+
+    // Управляющие байты хранятся отдельно от ячеек, по одному на ячейку:
+    // 0 — пустая, 1 — удалённая, 0x80 | 7 бит хеша — занятая.
+    // Пустая ячейка — это ноль, поэтому массив берётся из calloc
+    // и большие таблицы обнуляются лениво, страницами.
+    static constexpr uint8_t kEmpty = 0x00;
+    static constexpr uint8_t kDeleted = 0x01;
+    static constexpr uint8_t kFull = 0x80;
 
-        Cell() : isOccupied(false), isDeleted(false) {}
+    // сколько управляющих байтов сравнивается за раз (одна SSE2-группа)
+    static constexpr size_t kGroupWidth = 16;
+
+    // сколько ключей find_batch подгружает до того, как начать сравнения
+    static constexpr size_t kBatchSize = 16;
+
+    struct Table {
+        // capacity + kGroupWidth - 1 байтов: хвост дублирует начало,
+        // чтобы группу можно было читать без проверки на переход через край
+        uint8_t* ctrl = nullptr;
+        Cell* cells = nullptr;
+        // расстояние от домашней ячейки, только для RobinHood
+        uint32_t* dist = nullptr;
+        size_t capacity = 0;
+        // не nullptr, если массивы лежат в отображённом снимке:
+        // тогда освобождается вся область целиком через munmap
+        void* mapping = nullptr;
+        size_t mappingLength = 0;
     };
 
-    Cell* table;
+    // Заголовок снимка. Размеры типов записываются, чтобы снимок с
+    // другими Key/Value или другой сборки не был принят молча.
+    struct SnapshotHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t keySize;
+        uint32_t valueSize;
+        uint32_t cellSize;
+        uint8_t policy;
+        uint8_t mode;
+        uint8_t reserved[2];
+        float maxLoadFactor;
+        uint64_t capacity;
+        uint64_t size;
+        uint64_t deletedCount;
+        int32_t a;
+        int32_t b;
+        int32_t p;
+        uint32_t reserved2;
+        uint64_t seed;
+        uint64_t ctrlOffset;
+        uint64_t cellsOffset;
+        uint64_t distOffset;
+        uint64_t fileSize;
+        uint64_t checksum;
+    };
+
+    static constexpr char kSnapshotMagic[8] = {'H', 'T', 'O', 'A',
+        'S', 'N', 'A', 'P'};
+    static constexpr uint32_t kSnapshotVersion = 2;
+    // выравнивание массивов внутри файла (и внутри отображения)
+    static constexpr size_t kSnapshotAlign = 64;
+    // столько ячеек за раз проходит через буфер при записи и в сумму
+    static constexpr size_t kSnapshotChunk = 4096;
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+    // минимальная ёмкость при росте пустой таблицы
+    static constexpr size_t kMinCapacity = 16;
+    // сколько ячеек старой таблицы переносится за одну операцию
+    static constexpr size_t kMigrationSlice = 16;
+
+    Table table;
     size_t size;
-    size_t capacity;
     float loadFactor;
 
     int a, b;
     int p;
 
+    ProbingPolicy policy;
+    HashMode mode;
+    // соль перемешивания для HashMode::Fast, своя у каждого экземпляра
+    uint64_t seed = 0;
+
+    float maxLoadFactor = 0.75f;
+    mutable size_t deletedCount = 0;
+
+    // старая таблица, которая переносится в новую по частям
+    mutable Table oldTable;
+    mutable size_t migrateIndex = 0;
+
+    float tombstonePurgeRatio = 0.0f;
+
+    // счётчики для Telemetry = true; копия таблицы начинает с нуля
+    struct ProbeCounters {
+        std::array<std::atomic<uint64_t>, HashTableOAStats::kBuckets>
+            probes = {};
+        std::atomic<uint64_t> failedInserts{0};
+
+        ProbeCounters() = default;
+        ProbeCounters(const ProbeCounters&) {}
+        ProbeCounters& operator=(const ProbeCounters&) {
+            return *this;
+        }
+
+        void reset() {
+            for (auto& bucket : probes) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            failedInserts.store(0, std::memory_order_relaxed);
+        }
+
+        void swap(ProbeCounters& other) noexcept {
+            for (size_t i = 0; i < probes.size(); i++) {
+                probes[i].store(other.probes[i].exchange(
+                    probes[i].load(std::memory_order_relaxed),
+                    std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+            failedInserts.store(other.failedInserts.exchange(
+                failedInserts.load(std::memory_order_relaxed),
+                std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+    };
+    struct NoCounters {};
+
+    [[no_unique_address]] mutable
+        std::conditional_t<Telemetry, ProbeCounters, NoCounters> counters;
+
+    static size_t histogramBucket(size_t groups) {
+        size_t last = HashTableOAStats::kBuckets - 1;
+        return groups - 1 < last ? groups - 1 : last;
+    }
+
+    void recordProbe(size_t groups) const {
+        if constexpr (Telemetry) {
+            counters.probes[histogramBucket(groups)].fetch_add(1,
+                std::memory_order_relaxed);
+        }
+    }
+
     void init() {
         std::mt19937 gen(1337);
         std::uniform_int_distribution<int> dist(1, 1000);
         a = dist(gen);
         b = dist(gen);
+
+        if (mode == HashMode::Fast) {
+            std::random_device rd;
+            seed = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+        }
+    }
+
+    // в режиме Fast ёмкость всегда степень двойки
+    size_t roundCapacity(size_t capacity) const {
+        if (mode == HashMode::Fast && capacity > 0) {
+            return std::bit_ceil(capacity);
+        }
+        return capacity;
     }
 
-    size_t h1(const Key& key) const {
+    size_t wrap(size_t x, size_t capacity) const {
+        if (mode == HashMode::Fast) {
+            return x & (capacity - 1);
+        }
+        return x % capacity;
+    }
+
+    uint64_t hashValue(const LookupKey& key) const {
         uint64_t keyValue = 0;
 
         if constexpr (std::is_integral_v<Key> || std::is_floating_point_v<Key>) {
             keyValue = static_cast<uint64_t>(key);
+        } else if constexpr (std::is_same_v<LookupKey, std::string_view>) {
+            // строка читается по 8 байт, а не по одному символу;
+            // в режиме Fast результат уже перемешан и посолен
+            keyValue = hashing::hashBytes(key, seed);
+            if (mode == HashMode::Fast) {
+                return keyValue;
+            }
         } else {
             for (char c : key) {
                 keyValue = keyValue * 131 + static_cast<unsigned char>(c);
             }
         }
 
-        return static_cast<size_t>(((a * keyValue + b) % p) % capacity);
+        if (mode == HashMode::Fast) {
+            return hashing::mix(keyValue ^ seed,
+                0x9E3779B97F4A7C15ull ^ seed);
+        }
+        return (a * keyValue + b) % p;
     }
 
-    void swap(HashTableOA& other) noexcept {
-        std::swap(table, other.table);
-        std::swap(loadFactor, other.loadFactor);
-        std::swap(size, other.size);
-        std::swap(capacity, other.capacity);
+    // 7 бит хеша для управляющего байта, не связанные с номером ячейки
+    static uint8_t h2(uint64_t hash) {
+        return static_cast<uint8_t>(
+            kFull | ((hash * 0x9E3779B97F4A7C15ull) >> 57));
+    }
 
-        std::swap(a, other.a);
-        std::swap(b, other.b);
-        std::swap(p, other.p);
+    static bool isFull(uint8_t c) {
+        return (c & kFull) != 0;
+    }
+
+    // маска байтов группы, равных c
+    static uint32_t matchByte(const uint8_t* group, uint8_t c) {
+#if defined(__SSE2__)
+        __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        __m128i m = _mm_cmpeq_epi8(g, _mm_set1_epi8(static_cast<char>(c)));
+        return static_cast<uint32_t>(_mm_movemask_epi8(m));
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < kGroupWidth; i++) {
+            if (group[i] == c) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+#endif
+    }
+
+    // маска пустых и удалённых байтов группы (старший бит сброшен)
+    static uint32_t matchFree(const uint8_t* group) {
+#if defined(__SSE2__)
+        __m128i g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group));
+        return ~static_cast<uint32_t>(_mm_movemask_epi8(g)) & 0xFFFFu;
+#else
+        uint32_t mask = 0;
+        for (size_t i = 0; i < kGroupWidth; i++) {
+            if (!isFull(group[i])) {
+                mask |= 1u << i;
+            }
+        }
+        return mask;
+#endif
+    }
+
+    static Table allocateTable(size_t capacity,
+            ProbingPolicy policy = ProbingPolicy::Linear) {
+        Table t;
+        t.ctrl = static_cast<uint8_t*>(
+            std::calloc(capacity + kGroupWidth - 1, sizeof(uint8_t)));
+        if (!t.ctrl) {
+            throw std::bad_alloc();
+        }
+        if (capacity > 0) {
+            try {
+                t.cells = std::allocator<Cell>().allocate(capacity);
+                if (policy == ProbingPolicy::RobinHood) {
+                    t.dist = std::allocator<uint32_t>().allocate(capacity);
+                }
+            } catch (...) {
+                if (t.cells) {
+                    std::allocator<Cell>().deallocate(t.cells, capacity);
+                }
+                std::free(t.ctrl);
+                throw;
+            }
+        }
+        t.capacity = capacity;
+        return t;
+    }
+
+    static void releaseTable(Table& t) {
+        if (t.mapping) {
+            // в снимке только тривиальные типы, деструкторы не нужны
+            ::munmap(t.mapping, t.mappingLength);
+            t = Table();
+            return;
+        }
+        if (!t.ctrl) {
+            return;
+        }
+        if constexpr (!std::is_trivially_destructible_v<Cell>) {
+            for (size_t i = 0; i < t.capacity; i++) {
+                if (isFull(t.ctrl[i])) {
+                    t.cells[i].~Cell();
+                }
+            }
+        }
+        if (t.cells) {
+            std::allocator<Cell>().deallocate(t.cells, t.capacity);
+        }
+        if (t.dist) {
+            std::allocator<uint32_t>().deallocate(t.dist, t.capacity);
+        }
+        std::free(t.ctrl);
+        t = Table();
+    }
+
+    static size_t ctrlBytes(size_t capacity) {
+        return capacity + kGroupWidth - 1;
+    }
+
+    static uint64_t alignSnapshot(uint64_t offset) {
+        return (offset + kSnapshotAlign - 1) & ~(kSnapshotAlign - 1);
+    }
+
+    SnapshotHeader makeSnapshotHeader() const {
+        SnapshotHeader header = {};
+        std::memcpy(header.magic, kSnapshotMagic, sizeof(header.magic));
+        header.version = kSnapshotVersion;
+        header.keySize = sizeof(Key);
+        header.valueSize = sizeof(Value);
+        header.cellSize = sizeof(Cell);
+        header.policy = static_cast<uint8_t>(policy);
+        header.mode = static_cast<uint8_t>(mode);
+        header.maxLoadFactor = maxLoadFactor;
+        header.capacity = table.capacity;
+        header.size = size;
+        header.deletedCount = deletedCount;
+        header.a = a;
+        header.b = b;
+        header.p = p;
+        header.seed = seed;
+
+        header.ctrlOffset = alignSnapshot(sizeof(SnapshotHeader));
+        header.cellsOffset = alignSnapshot(header.ctrlOffset
+            + ctrlBytes(table.capacity));
+        header.distOffset = alignSnapshot(header.cellsOffset
+            + table.capacity * sizeof(Cell));
+        header.fileSize = table.dist
+            ? header.distOffset + table.capacity * sizeof(uint32_t)
+            : header.cellsOffset + table.capacity * sizeof(Cell);
+        return header;
+    }
+
+    // nullptr, если заголовок подходит этой таблице и длине файла
+    static const char* checkSnapshotHeader(const SnapshotHeader& header,
+                                           size_t length) {
+        if (std::memcmp(header.magic, kSnapshotMagic,
+                sizeof(header.magic)) != 0
+            || header.version != kSnapshotVersion) {
+            return "Not a HashTableOA snapshot";
+        }
+        if (header.keySize != sizeof(Key) || header.valueSize != sizeof(Value)
+            || header.cellSize != sizeof(Cell)) {
+            return "Snapshot was written for different Key/Value types";
+        }
+        if (header.fileSize != length || header.capacity > length
+            || header.ctrlOffset < sizeof(SnapshotHeader)
+            || header.ctrlOffset % kSnapshotAlign != 0
+            || header.cellsOffset % kSnapshotAlign != 0
+            || header.distOffset % kSnapshotAlign != 0
+            || header.ctrlOffset + ctrlBytes(header.capacity)
+                > header.cellsOffset
+            || header.cellsOffset + header.capacity * sizeof(Cell) > length
+            || header.size > header.capacity) {
+            return "Snapshot is truncated";
+        }
+        if (header.policy > static_cast<uint8_t>(ProbingPolicy::RobinHood)
+            || header.mode > static_cast<uint8_t>(HashMode::Fast)) {
+            return "Snapshot has unknown policy or hash mode";
+        }
+        if (header.mode == static_cast<uint8_t>(HashMode::Fast)
+            && header.capacity > 0 && !std::has_single_bit(header.capacity)) {
+            return "Snapshot capacity is not a power of two";
+        }
+        if (header.deletedCount > header.capacity - header.size
+            || !(header.maxLoadFactor > 0.0f && header.maxLoadFactor <= 1.0f)) {
+            return "Snapshot has inconsistent table parameters";
+        }
+        if (header.policy == static_cast<uint8_t>(ProbingPolicy::RobinHood)
+            && header.distOffset + header.capacity * sizeof(uint32_t)
+                > length) {
+            return "Snapshot is truncated";
+        }
+        return nullptr;
+    }
+
+    // заголовок с обнулённым полем суммы, затем управляющие байты
+    static uint64_t snapshotChecksumStart(const SnapshotHeader& header,
+                                          const Table& t) {
+        SnapshotHeader zeroed = header;
+        zeroed.checksum = 0;
+        uint64_t sum = hashing::hashBytes(&zeroed, sizeof(zeroed));
+        return hashing::hashBytes(snapshotCtrl(t), ctrlBytes(t.capacity),
+            sum);
+    }
+
+    // После clean() и перемещения массивов нет вовсе: в снимок идут
+    // нулевые управляющие байты таблицы ёмкости 0, такой снимок
+    // загружается как обычный.
+    static const uint8_t* snapshotCtrl(const Table& t) {
+        static constexpr uint8_t kNoCtrl[kGroupWidth - 1] = {};
+        return t.ctrl ? t.ctrl : kNoCtrl;
+    }
+
+    // та же цепочка, что в saveSnapshot: массивы порциями kSnapshotChunk
+    static uint64_t snapshotChecksum(const SnapshotHeader& header,
+                                     const Table& t) {
+        uint64_t sum = snapshotChecksumStart(header, t);
+        for (size_t i = 0; t.cells && i < t.capacity; i += kSnapshotChunk) {
+            size_t count = std::min(kSnapshotChunk, t.capacity - i);
+            sum = hashing::hashBytes(t.cells + i, count * sizeof(Cell), sum);
+        }
+        for (size_t i = 0; t.dist && i < t.capacity; i += kSnapshotChunk) {
+            size_t count = std::min(kSnapshotChunk, t.capacity - i);
+            sum = hashing::hashBytes(t.dist + i, count * sizeof(uint32_t),
+                sum);
+        }
+        return sum;
+    }
+
+    // запись байта вместе с его копией в хвосте массива
+    static void setCtrl(const Table& t, size_t index, uint8_t c) {
+        t.ctrl[index] = c;
+        for (size_t j = index; j < kGroupWidth - 1; j += t.capacity) {
+            t.ctrl[t.capacity + j] = c;
+        }
+    }
+
+    static void eraseAt(const Table& t, size_t index) {
+        t.cells[index].~Cell();
+        setCtrl(t, index, kDeleted);
+    }
+
+    bool needsGrowth() const {
+        return static_cast<float>(size + deletedCount + 1)
+            > maxLoadFactor * static_cast<float>(table.capacity);
+    }
+
+    // индекс живой ячейки с ключом key в t или npos;
+    // группа с пустой ячейкой завершает поиск
+    size_t probe(const Table& t, uint64_t hash,
+                 const LookupKey& key) const {
+        if (t.capacity == 0) {
+            return npos;
+        }
+
+        uint8_t tag = h2(hash);
+        size_t pos = wrap(hash, t.capacity);
+        for (size_t probed = 0; probed < t.capacity; probed += kGroupWidth) {
+            const uint8_t* group = t.ctrl + pos;
+
+            for (uint32_t m = matchByte(group, tag); m != 0; m &= m - 1) {
+                size_t index = wrap(pos + std::countr_zero(m), t.capacity);
+                if (t.cells[index].key == key) {
+                    recordProbe(probed / kGroupWidth + 1);
+                    return index;
+                }
+            }
+
+            if (matchByte(group, kEmpty) != 0) {
+                recordProbe(probed / kGroupWidth + 1);
+                return npos;
+            }
+            pos = wrap(pos + kGroupWidth, t.capacity);
+        }
+
+        recordProbe(t.capacity / kGroupWidth + 1);
+        return npos;
+    }
+
+    // то же, что probe по текущей таблице, но заодно запоминает
+    // первую свободную ячейку на пути
+    size_t probeForInsert(uint64_t hash, const LookupKey& key,
+                          size_t& freeIndex) const {
+        freeIndex = npos;
+
+        uint8_t tag = h2(hash);
+        size_t pos = wrap(hash, table.capacity);
+        for (size_t probed = 0; probed < table.capacity;
+                probed += kGroupWidth) {
+            const uint8_t* group = table.ctrl + pos;
+
+            for (uint32_t m = matchByte(group, tag); m != 0; m &= m - 1) {
+                size_t index = wrap(pos + std::countr_zero(m), table.capacity);
+                if (table.cells[index].key == key) {
+                    recordProbe(probed / kGroupWidth + 1);
+                    return index;
+                }
+            }
+
+            if (freeIndex == npos) {
+                uint32_t free = matchFree(group);
+                if (free != 0) {
+                    freeIndex = wrap(pos + std::countr_zero(free),
+                        table.capacity);
+                }
+            }
+
+            if (matchByte(group, kEmpty) != 0) {
+                recordProbe(probed / kGroupWidth + 1);
+                return npos;
+            }
+            pos = wrap(pos + kGroupWidth, table.capacity);
+        }
+
+        recordProbe(table.capacity / kGroupWidth + 1);
+        return npos;
+    }
+
+    const Cell* locate(const LookupKey& key) const {
+        return locate(key, hashValue(key));
+    }
+
+    const Cell* locate(const LookupKey& key, uint64_t hash) const {
+        size_t index = probe(table, hash, key);
+        if (index != npos) {
+            return &table.cells[index];
+        }
+
+        if (oldTable.ctrl) {
+            index = probe(oldTable, hash, key);
+            if (index != npos) {
+                return &oldTable.cells[index];
+            }
+        }
+
+        return nullptr;
+    }
+
+    // подсказка процессору загрузить управляющие байты и ячейку,
+    // с которых начнётся пробирование
+    void prefetchHome(uint64_t hash) const {
+        if (table.capacity == 0) {
+            return;
+        }
+        size_t index = wrap(hash, table.capacity);
+#if defined(__GNUC__)
+        __builtin_prefetch(table.ctrl + index);
+        __builtin_prefetch(table.cells + index);
+#endif
+    }
+
+    // начинаем рост: текущая таблица становится старой и переносится
+    // постепенно, без одной долгой перестройки
+    void grow() {
+        finishMigration();
+
+        size_t newCapacity = table.capacity * 2;
+        if (deletedCount > size) {
+            // в основном надгробия, достаточно перестроить на месте
+            newCapacity = table.capacity;
+        }
+        if (newCapacity < kMinCapacity) {
+            newCapacity = kMinCapacity;
+        }
+
+        Table fresh = allocateTable(newCapacity, policy);
+        if (size == 0) {
+            releaseTable(table);
+        } else {
+            oldTable = table;
+            migrateIndex = 0;
+        }
+
+        table = fresh;
+        deletedCount = 0;
+        loadFactor = getLoadFactor();
+    }
+
+    // переносит очередную порцию ячеек старой таблицы
+    void migrateStep(size_t slice = kMigrationSlice) const {
+        if (!oldTable.ctrl) {
+            return;
+        }
+
+        size_t end = migrateIndex + slice;
+        if (end > oldTable.capacity) {
+            end = oldTable.capacity;
+        }
+
+        for (; migrateIndex < end; migrateIndex++) {
+            if (isFull(oldTable.ctrl[migrateIndex])) {
+                moveToTable(oldTable.cells[migrateIndex]);
+                eraseAt(oldTable, migrateIndex);
+            }
+        }
+
+        if (migrateIndex == oldTable.capacity) {
+            releaseTable(oldTable);
+            migrateIndex = 0;
+        }
+    }
+
+    void finishMigration() const {
+        if (oldTable.ctrl) {
+            migrateStep(oldTable.capacity);
+        }
+    }
+
+    // ключа точно нет в новой таблице, дубликаты не проверяем
+    void moveToTable(Cell& from) const {
+        uint64_t hash = hashValue(from.key);
+        if (policy == ProbingPolicy::RobinHood) {
+            placeRobinHood(std::move(from), hash);
+            return;
+        }
+
+        size_t pos = wrap(hash, table.capacity);
+        for (size_t probed = 0; probed < table.capacity;
+                probed += kGroupWidth) {
+            uint32_t free = matchFree(table.ctrl + pos);
+            if (free != 0) {
+                size_t index = wrap(pos + std::countr_zero(free),
+                    table.capacity);
+                if (table.ctrl[index] == kDeleted) {
+                    deletedCount--;
+                }
+                new (&table.cells[index]) Cell(std::move(from));
+                setCtrl(table, index, h2(hash));
+                return;
+            }
+            pos = wrap(pos + kGroupWidth, table.capacity);
+        }
+    }
+
+    // общий путь вставки: ищем ключ в обеих таблицах и заодно
+    // запоминаем свободную ячейку, а запись конструируем только при
+    // промахе; key и args до этого момента не изменяются
+    template <typename K, typename... Args>
+    std::pair<Value*, bool> emplaceImpl(K&& key, Args&&... args) {
+        migrateStep();
+        uint64_t hash = hashValue(key);
+
+        // ключ мог ещё не переехать из старой таблицы
+        if (oldTable.ctrl) {
+            size_t oldIndex = probe(oldTable, hash, key);
+            if (oldIndex != npos) {
+                return {&oldTable.cells[oldIndex].value, false};
+            }
+        }
+
+        if (table.capacity == 0) {
+            grow();
+        }
+
+        size_t freeIndex;
+        size_t index = probeForInsert(hash, key, freeIndex);
+        if (index != npos) {
+            return {&table.cells[index].value, false};
+        }
+
+        // пустую ячейку занимаем только если не пора расти,
+        // удалённую можно переиспользовать всегда
+        bool reuse = freeIndex != npos && table.ctrl[freeIndex] == kDeleted;
+        if (!reuse && needsGrowth()) {
+            grow();
+            return emplaceImpl(std::forward<K>(key),
+                std::forward<Args>(args)...);
+        }
+
+        if (freeIndex == npos) {
+            if constexpr (Telemetry) {
+                counters.failedInserts.fetch_add(1,
+                    std::memory_order_relaxed);
+            }
+            std::cerr << "Error: table is full!" << std::endl;
+            return {nullptr, false};
+        }
+
+        if (policy == ProbingPolicy::RobinHood) {
+            index = placeRobinHood(Cell{Key(std::forward<K>(key)),
+                Value(std::forward<Args>(args)...)}, hash);
+        } else {
+            new (&table.cells[freeIndex]) Cell{Key(std::forward<K>(key)),
+                Value(std::forward<Args>(args)...)};
+            if (reuse) {
+                deletedCount--;
+            }
+            setCtrl(table, freeIndex, h2(hash));
+            index = freeIndex;
+        }
+
+        size++;
+        loadFactor = getLoadFactor();
+        return {&table.cells[index].value, true};
+    }
+
+    template <typename K, typename M>
+    std::pair<Value*, bool> assignImpl(K&& key, M&& obj) {
+        auto result = emplaceImpl(std::forward<K>(key), std::forward<M>(obj));
+        // при вставке obj уже ушёл в ячейку, иначе он ещё не тронут
+        if (!result.second && result.first) {
+            *result.first = std::forward<M>(obj);
+        }
+        return result;
+    }
+
+    // вставка Robin Hood: идём от домашней ячейки и отдаём место
+    // ключу, который ушёл от своей ячейки дальше, чем текущий;
+    // возвращает ячейку, куда попала сама вставляемая запись
+    size_t placeRobinHood(Cell&& from, uint64_t hash) const {
+        Cell entry(std::move(from));
+        uint8_t tag = h2(hash);
+        uint32_t d = 0;
+        size_t index = wrap(hash, table.capacity);
+        size_t placed = npos;
+
+        while (isFull(table.ctrl[index])) {
+            if (table.dist[index] < d) {
+                if (placed == npos) {
+                    placed = index;
+                }
+                std::swap(entry, table.cells[index]);
+                uint8_t displacedTag = table.ctrl[index];
+                setCtrl(table, index, tag);
+                tag = displacedTag;
+                std::swap(d, table.dist[index]);
+            }
+            index = wrap(index + 1, table.capacity);
+            d++;
+        }
+
+        new (&table.cells[index]) Cell(std::move(entry));
+        table.dist[index] = d;
+        setCtrl(table, index, tag);
+        return placed == npos ? index : placed;
+    }
+
+    // удаление Robin Hood: следующие ключи цепочки сдвигаются на одну
+    // ячейку ближе к дому, пока не встретится пустая или "домашняя"
+    void eraseWithBackwardShift(size_t index) {
+        table.cells[index].~Cell();
+
+        size_t next = wrap(index + 1, table.capacity);
+        while (isFull(table.ctrl[next]) && table.dist[next] > 0) {
+            new (&table.cells[index]) Cell(std::move(table.cells[next]));
+            table.cells[next].~Cell();
+            table.dist[index] = table.dist[next] - 1;
+            setCtrl(table, index, table.ctrl[next]);
+
+            index = next;
+            next = wrap(next + 1, table.capacity);
+        }
+
+        setCtrl(table, index, kEmpty);
     }
 };
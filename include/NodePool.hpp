@@ -0,0 +1,182 @@
+// Copyright message
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// Пул узлов одного размера. Память берётся плитами по kSlabBytes,
+// узлы нарезаются из плиты подряд, а освобождённые узлы уходят в
+// список свободных и выдаются снова — malloc на каждый узел нет.
+// Плиты возвращаются системе только все разом: в release() или в
+// деструкторе; после release() все выданные узлы недействительны.
+//
+// Размер узла фиксируется первым запросом; запросы другого размера
+// или с выравниванием больше max_align_t идут в обычную кучу.
+class NodePool {
+ public:
+    NodePool() = default;
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    ~NodePool() {
+        release();
+    }
+
+    void* allocate(size_t size, size_t align) {
+        if (!fits(size, align)) {
+            return ::operator new(size);
+        }
+
+        if (freeList) {
+            FreeNode* node = freeList;
+            freeList = node->next;
+            inUse++;
+            return node;
+        }
+        if (slabCursor + blockSize > slabEnd) {
+            addSlab();
+        }
+        void* node = slabCursor;
+        slabCursor += blockSize;
+        inUse++;
+        return node;
+    }
+
+    void deallocate(void* node, size_t size, size_t align) noexcept {
+        if (!node) {
+            return;
+        }
+        if (!pooled(size, align)) {
+            ::operator delete(node);
+            return;
+        }
+        auto* free = static_cast<FreeNode*>(node);
+        free->next = freeList;
+        freeList = free;
+        inUse--;
+    }
+
+    // освобождает все плиты сразу, без обхода узлов
+    void release() noexcept {
+        while (slabs) {
+            Slab* next = slabs->next;
+            ::operator delete(slabs);
+            slabs = next;
+        }
+        freeList = nullptr;
+        slabCursor = nullptr;
+        slabEnd = nullptr;
+        slabCount = 0;
+        inUse = 0;
+    }
+
+    // выданные и ещё не возвращённые узлы
+    size_t getNodesInUse() const {
+        return inUse;
+    }
+
+    size_t getSlabCount() const {
+        return slabCount;
+    }
+
+    size_t getBytesReserved() const {
+        return slabCount * kSlabBytes;
+    }
+
+ private:
+    static constexpr size_t kSlabBytes = 64 * 1024;
+
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    struct alignas(std::max_align_t) Slab {
+        Slab* next;
+    };
+
+    size_t nodeSize = 0;   // размер из первого запроса
+    size_t blockSize = 0;  // с округлением до выравнивания
+    FreeNode* freeList = nullptr;
+    Slab* slabs = nullptr;
+    char* slabCursor = nullptr;
+    char* slabEnd = nullptr;
+    size_t slabCount = 0;
+    size_t inUse = 0;
+
+    bool fits(size_t size, size_t align) {
+        if (nodeSize == 0 && align <= alignof(std::max_align_t)) {
+            nodeSize = size;
+            size_t step = alignof(std::max_align_t);
+            size_t block = size < sizeof(FreeNode) ? sizeof(FreeNode) : size;
+            blockSize = (block + step - 1) / step * step;
+        }
+        return pooled(size, align);
+    }
+
+    bool pooled(size_t size, size_t align) const {
+        return size == nodeSize && align <= alignof(std::max_align_t)
+            && blockSize <= kSlabBytes - sizeof(Slab);
+    }
+
+    void addSlab() {
+        auto* slab = static_cast<Slab*>(::operator new(kSlabBytes));
+        slab->next = slabs;
+        slabs = slab;
+        slabCursor = reinterpret_cast<char*>(slab) + sizeof(Slab);
+        slabEnd = reinterpret_cast<char*>(slab) + kSlabBytes;
+        slabCount++;
+    }
+};
+
+// Распределитель для контейнеров (DL_list, HashTable), берущий узлы
+// из NodePool. Копии и перепривязки к другому типу делят один пул;
+// пул должен жить дольше контейнеров.
+template <typename T>
+class PoolAllocator {
+ public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit PoolAllocator(NodePool& pool) noexcept : pool_(&pool) {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept  // NOLINT
+        : pool_(other.pool()) {}
+
+    T* allocate(size_t n) {
+        if (n != 1) {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T*>(pool_->allocate(sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (n != 1) {
+            std::allocator<T>().deallocate(p, n);
+            return;
+        }
+        pool_->deallocate(p, sizeof(T), alignof(T));
+    }
+
+    NodePool* pool() const noexcept {
+        return pool_;
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept {
+        return pool_ == other.pool();
+    }
+
+ private:
+    NodePool* pool_;
+};
+
+template <typename A>
+inline constexpr bool kIsPoolAllocator = false;
+
+template <typename T>
+inline constexpr bool kIsPoolAllocator<PoolAllocator<T>> = true;
@@ -0,0 +1,171 @@
+// Copyright message
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <shared_mutex>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "../include/HashFunctions.hpp"
+#include "../include/HashTableOA.hpp"
+
+// Потокобезопасная обёртка над HashTableOA: ключи раскладываются по
+// независимым шардам старшими битами хеша, у каждого шарда свой
+// shared_mutex. Чтения берут общий замок и идут параллельно, пока шард
+// не перестраивается; запись блокирует только свой шард.
+template <typename Key, typename Value>
+class ShardedHashTableOA {
+ public:
+    using LookupKey = typename HashTableOA<Key, Value>::LookupKey;
+
+    explicit ShardedHashTableOA(size_t capacity, size_t shardCount = 64)
+        : shardBits(0) {
+        if (shardCount == 0) {
+            shardCount = 1;
+        }
+        shardCount = std::bit_ceil(shardCount);
+        shardBits = std::countr_zero(shardCount);
+
+        std::random_device rd;
+        seed = (static_cast<uint64_t>(rd()) << 32) ^ rd();
+
+        int perShard = static_cast<int>(capacity / shardCount + 1);
+        shards = std::make_unique<Shard[]>(shardCount);
+        count = shardCount;
+        for (size_t i = 0; i < count; i++) {
+            shards[i].table = HashTableOA<Key, Value>(perShard,
+                HashMode::Fast);
+        }
+    }
+
+    ShardedHashTableOA(const ShardedHashTableOA&) = delete;
+    ShardedHashTableOA& operator=(const ShardedHashTableOA&) = delete;
+
+    bool insert(const Key& key, const Value& value) {
+        Shard& shard = shardFor(key);
+        std::unique_lock lock(shard.mutex);
+        return shard.table.insert(key, value);
+    }
+
+    // true — ключ добавлен, false — значение ключа перезаписано
+    template <typename M>
+    bool insert_or_assign(const Key& key, M&& obj) {
+        Shard& shard = shardFor(key);
+        std::unique_lock lock(shard.mutex);
+        return shard.table.insert_or_assign(key, std::forward<M>(obj))
+            .second;
+    }
+
+    // true — ключ добавлен, false — ключ уже был, args не тронуты
+    template <typename... Args>
+    bool try_emplace(const Key& key, Args&&... args) {
+        Shard& shard = shardFor(key);
+        std::unique_lock lock(shard.mutex);
+        return shard.table.try_emplace(key, std::forward<Args>(args)...)
+            .second;
+    }
+
+    bool isPresent(const LookupKey& key) const {
+        return read(key, [&](const HashTableOA<Key, Value>& table) {
+            return table.find_ptr(key) != nullptr;
+        });
+    }
+
+    Value find(const LookupKey& key) const {
+        return read(key, [&](const HashTableOA<Key, Value>& table) {
+            const Value* value = table.find_ptr(key);
+            return value ? *value : Value();
+        });
+    }
+
+    // копия значения или nullopt; указатель наружу отдать нельзя,
+    // потому что замок шарда снимается при выходе
+    std::optional<Value> try_get(const LookupKey& key) const {
+        return read(key, [&](const HashTableOA<Key, Value>& table)
+                -> std::optional<Value> {
+            const Value* value = table.find_ptr(key);
+            if (!value) {
+                return std::nullopt;
+            }
+            return *value;
+        });
+    }
+
+    bool remove(const LookupKey& key) {
+        Shard& shard = shardFor(key);
+        std::unique_lock lock(shard.mutex);
+        return shard.table.remove(key);
+    }
+
+    // сумма по шардам; при параллельных записях — моментальный срез
+    // каждого шарда, а не всей таблицы сразу
+    size_t getSize() const {
+        size_t total = 0;
+        for (size_t i = 0; i < count; i++) {
+            std::shared_lock lock(shards[i].mutex);
+            total += shards[i].table.getSize();
+        }
+        return total;
+    }
+
+    size_t getShardCount() const {
+        return count;
+    }
+
+    void clean() {
+        for (size_t i = 0; i < count; i++) {
+            std::unique_lock lock(shards[i].mutex);
+            shards[i].table.clean();
+        }
+    }
+
+ private:
+    // каждый шард на своей кэш-линии, чтобы замки не делили линию
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        HashTableOA<Key, Value> table{0, HashMode::Fast};
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    size_t count = 0;
+    int shardBits;
+    uint64_t seed = 0;
+
+    uint64_t routeHash(const LookupKey& key) const {
+        if constexpr (std::is_same_v<LookupKey, std::string_view>) {
+            return hashing::hashBytes(key, seed);
+        } else {
+            return hashing::mix(static_cast<uint64_t>(key) ^ seed,
+                hashing::kSecret1);
+        }
+    }
+
+    // шард выбирается старшими битами; у таблицы шарда своя соль,
+    // так что внутри шарда ключи распределяются независимо
+    Shard& shardFor(const LookupKey& key) const {
+        if (shardBits == 0) {
+            return shards[0];
+        }
+        return shards[routeHash(key) >> (64 - shardBits)];
+    }
+
+    // Чтение под общим замком. Пока шард постепенно перестраивается,
+    // поиск сам переносит ячейки, поэтому в этом случае берём
+    // исключительный замок.
+    template <typename F>
+    auto read(const LookupKey& key, F&& lookup) const {
+        Shard& shard = shardFor(key);
+        {
+            std::shared_lock lock(shard.mutex);
+            if (!shard.table.isRehashing()) {
+                return lookup(shard.table);
+            }
+        }
+        std::unique_lock lock(shard.mutex);
+        return lookup(shard.table);
+    }
+};
@@ -290,6 +290,21 @@ bool test_hashtable_oa_serialization() {
         if (loaded.find(5) != 50 || loaded.find(7) != 70) FAIL("Binary: data mismatch");
     }
 
+    // снимок с отображением в память
+    {
+        HashTableOA<int, int> table(100);
+        table.insert(8, 80);
+        table.insert(9, 90);
+
+        table.saveSnapshot("test_htoa_snapshot.bin");
+
+        HashTableOA<int, int> loaded(10);
+        loaded.loadSnapshot("test_htoa_snapshot.bin");
+
+        if (loaded.getSize() != 2) FAIL("Snapshot: size mismatch");
+        if (loaded.find(8) != 80 || loaded.find(9) != 90) FAIL("Snapshot: data mismatch");
+    }
+
     PASS();
     return true;
 }
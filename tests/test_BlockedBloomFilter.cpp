@@ -0,0 +1,53 @@
+// Copyright message
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "../include/BlockedBloomFilter.hpp"
+#include "../include/HashFunctions.hpp"
+
+static uint64_t keyHash(uint64_t key) {
+    return hashing::mix(key, hashing::kSecret1);
+}
+
+TEST(BlockedBloomFilterTest, NoFalseNegatives) {
+    BlockedBloomFilter filter(10000);
+    for (uint64_t key = 0; key < 10000; key++)
+        filter.add(keyHash(key));
+
+    for (uint64_t key = 0; key < 10000; key++)
+        ASSERT_TRUE(filter.mayContain(keyHash(key)));
+    EXPECT_EQ(filter.getAdded(), 10000);
+}
+
+TEST(BlockedBloomFilterTest, FalsePositiveRateNearTarget) {
+    BlockedBloomFilter filter(100000, 0.01);
+    for (uint64_t key = 0; key < 100000; key++)
+        filter.add(keyHash(key));
+
+    size_t falsePositives = 0;
+    for (uint64_t key = 1000000; key < 1100000; key++)
+        falsePositives += filter.mayContain(keyHash(key));
+
+    // блочный фильтр чуть хуже классического; с запасом по битам
+    // ожидаем около 1%, проверяем с допуском
+    EXPECT_LT(falsePositives, 2000);
+    EXPECT_GE(filter.getHashCount(), 1);
+}
+
+TEST(BlockedBloomFilterTest, RebuildThresholdsAndClear) {
+    BlockedBloomFilter filter(100);
+    for (uint64_t key = 0; key < 100; key++)
+        filter.add(keyHash(key));
+    EXPECT_FALSE(filter.needsRebuild());
+
+    for (int i = 0; i < 26; i++) filter.noteRemoval();
+    EXPECT_TRUE(filter.needsRebuild());
+
+    filter.clear();
+    EXPECT_EQ(filter.getAdded(), 0);
+    EXPECT_EQ(filter.getRemoved(), 0);
+    EXPECT_FALSE(filter.mayContain(keyHash(5)));
+
+    for (uint64_t key = 0; key < 201; key++)
+        filter.add(keyHash(key));
+    EXPECT_TRUE(filter.needsRebuild());
+}
@@ -0,0 +1,104 @@
+// Copyright message
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/ConcurrentHashTableChains.hpp"
+
+// BASICS
+
+TEST(ConcurrentHashTableChainsTest, InsertFindRemove) {
+    ConcurrentHashTableChains<int, int> ht(16, 4);
+    EXPECT_EQ(ht.getLockCount(), 4u);
+
+    EXPECT_TRUE(ht.insert(1, 10));
+    EXPECT_TRUE(ht.insert(2, 20));
+    EXPECT_FALSE(ht.insert(1, 11));  // как HashTable: значение прежнее
+
+    EXPECT_EQ(ht.getSize(), 2u);
+    EXPECT_EQ(ht.find(1), 10);
+    EXPECT_EQ(ht.find(3), 0);
+    EXPECT_FALSE(ht.try_get(3).has_value());
+
+    EXPECT_EQ(ht.remove(1), 10);
+    EXPECT_FALSE(ht.remove(1).has_value());
+    EXPECT_FALSE(ht.isPresent(1));
+    EXPECT_TRUE(ht.isPresent(2));
+    EXPECT_EQ(ht.getSize(), 1u);
+
+    ht.clean();
+    EXPECT_EQ(ht.getSize(), 0u);
+    EXPECT_FALSE(ht.isPresent(2));
+}
+
+TEST(ConcurrentHashTableChainsTest, GrowsWithStringKeys) {
+    ConcurrentHashTableChains<std::string, std::string> ht(1, 8);
+    EXPECT_EQ(ht.getCapacity(), 8u);
+
+    for (int i = 0; i < 5000; i++)
+        ht.insert("key" + std::to_string(i), std::to_string(i));
+    EXPECT_GE(ht.getCapacity(), 2048u);
+    EXPECT_EQ(ht.getSize(), 5000u);
+
+    for (int i = 0; i < 5000; i += 2)
+        EXPECT_EQ(ht.remove("key" + std::to_string(i)), std::to_string(i));
+    for (int i = 0; i < 5000; i++)
+        ASSERT_EQ(ht.find("key" + std::to_string(i)),
+            i % 2 ? std::to_string(i) : "");
+
+    ht.clean();
+    ht.insert("again", "1");
+    EXPECT_EQ(ht.find("again"), "1");
+}
+
+
+// STRESS
+
+// Постоянные ключи читатели находят всегда, в том числе пока писатели
+// растят таблицу; лишние ключи каждого писателя вставляются и частью
+// удаляются, итоговый размер известен точно.
+TEST(ConcurrentHashTableChainsTest, ConcurrentWritersAndReaders) {
+    ConcurrentHashTableChains<uint64_t, uint64_t> ht(16, 16);
+    const uint64_t stableKeys = 512;
+    for (uint64_t key = 0; key < stableKeys; key++)
+        ht.insert(key, key * 3);
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> errors{0};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; t++) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                for (uint64_t key = 0; key < stableKeys; key++) {
+                    auto value = ht.try_get(key);
+                    if (!value || *value != key * 3) errors++;
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (uint64_t w = 0; w < 3; w++) {
+        writers.emplace_back([&, w] {
+            for (uint64_t round = 0; round < 20000; round++) {
+                uint64_t extra = stableKeys + w * 1000000 + round;
+                if (!ht.insert(extra, extra)) errors++;
+                if (round % 2 && ht.remove(extra) != extra) errors++;
+            }
+        });
+    }
+
+    for (auto& w : writers) w.join();
+    stop.store(true);
+    for (auto& r : readers) r.join();
+
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_EQ(ht.getSize(), stableKeys + 3 * 10000);
+    for (uint64_t w = 0; w < 3; w++) {
+        EXPECT_TRUE(ht.isPresent(stableKeys + w * 1000000));
+        EXPECT_FALSE(ht.isPresent(stableKeys + w * 1000000 + 1));
+    }
+}
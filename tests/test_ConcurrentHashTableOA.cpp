@@ -0,0 +1,155 @@
+// Copyright message
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "../include/ConcurrentHashTableOA.hpp"
+
+// BASICS
+
+TEST(ConcurrentHashTableOATest, InsertFindRemove) {
+    ConcurrentHashTableOA<int, int> ht(16);
+
+    EXPECT_TRUE(ht.insert(1, 10));
+    EXPECT_TRUE(ht.insert(2, 20));
+    EXPECT_FALSE(ht.insert(1, 11));
+
+    EXPECT_EQ(ht.getSize(), 2);
+    EXPECT_EQ(ht.find(1), 11);
+    EXPECT_EQ(ht.find(3), 0);
+    EXPECT_FALSE(ht.try_get(3).has_value());
+
+    EXPECT_TRUE(ht.remove(1));
+    EXPECT_FALSE(ht.remove(1));
+    EXPECT_FALSE(ht.isPresent(1));
+    EXPECT_TRUE(ht.isPresent(2));
+    EXPECT_EQ(ht.getSize(), 1);
+
+    ht.clean();
+    EXPECT_EQ(ht.getSize(), 0);
+    EXPECT_FALSE(ht.isPresent(2));
+}
+
+TEST(ConcurrentHashTableOATest, GrowsAndReusesTombstones) {
+    ConcurrentHashTableOA<uint64_t, uint64_t> ht(16);
+
+    for (uint64_t key = 0; key < 10000; key++)
+        ht.insert(key, key + 1);
+    EXPECT_GE(ht.getCapacity(), 10000u);
+
+    for (uint64_t key = 0; key < 10000; key += 2)
+        ht.remove(key);
+
+    // удаления и вставки по кругу не должны раздувать таблицу
+    size_t capacity = ht.getCapacity();
+    for (uint64_t round = 0; round < 20; round++) {
+        for (uint64_t key = 100000; key < 102000; key++)
+            ht.insert(key, key);
+        for (uint64_t key = 100000; key < 102000; key++)
+            ht.remove(key);
+    }
+    EXPECT_EQ(ht.getCapacity(), capacity);
+
+    EXPECT_EQ(ht.getSize(), 5000);
+    for (uint64_t key = 0; key < 10000; key++)
+        ASSERT_EQ(ht.find(key), key % 2 ? key + 1 : 0);
+}
+
+
+// STRESS
+
+// Значение кодирует ключ в младших 32 битах и номер записи в старших:
+// разорванное чтение (ключ от одной записи, значение от другой)
+// сразу видно. Постоянные ключи читатели должны находить всегда,
+// в том числе пока писатели растят таблицу.
+TEST(ConcurrentHashTableOATest, ReadersNeverSeeTornOrMissingEntries) {
+    ConcurrentHashTableOA<uint64_t, uint64_t> ht(16);
+    const uint64_t stableKeys = 512;
+    for (uint64_t key = 0; key < stableKeys; key++)
+        ht.insert(key, key);
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> errors{0};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                for (uint64_t key = 0; key < stableKeys; key++) {
+                    auto value = ht.try_get(key);
+                    if (!value || (*value & 0xFFFFFFFF) != key) errors++;
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (uint64_t w = 0; w < 2; w++) {
+        writers.emplace_back([&, w] {
+            for (uint64_t round = 1; round <= 20000; round++) {
+                uint64_t key = round % stableKeys;
+                ht.insert(key, (round << 32) | key);
+
+                uint64_t extra = stableKeys + w * 1000000 + round;
+                ht.insert(extra, extra);
+                if (round % 2) ht.remove(extra);
+            }
+        });
+    }
+
+    for (auto& w : writers) w.join();
+    stop.store(true);
+    for (auto& r : readers) r.join();
+
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_EQ(ht.getSize(), stableKeys + 2 * 10000);
+}
+
+// Перестройки от удалений и вставок по кругу, пока читатели держат
+// эпохи: прежние массивы освобождаются, их число не растёт.
+TEST(ConcurrentHashTableOATest, RetiredTablesStayBounded) {
+    ConcurrentHashTableOA<uint64_t, uint64_t> ht(16);
+    const uint64_t liveKeys = 1400;
+    for (uint64_t key = 0; key < liveKeys; key++)
+        ht.insert(key, key);
+
+    for (uint64_t round = 0; round < 200000; round++) {
+        ht.insert(liveKeys + round, round);
+        ht.remove(liveKeys + round);
+    }
+    EXPECT_LE(ht.getRetiredCount(), 1u);
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> errors{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; t++) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                for (uint64_t key = 0; key < liveKeys; key += 7) {
+                    if (ht.find(key) != key) errors++;
+                }
+            }
+        });
+    }
+
+    size_t maxRetired = 0;
+    for (uint64_t round = 0; round < 200000; round++) {
+        uint64_t key = 10000000 + round;
+        ht.insert(key, round);
+        ht.remove(key);
+        if (round % 1000 == 0) {
+            maxRetired = std::max(maxRetired, ht.getRetiredCount());
+        }
+    }
+    stop.store(true);
+    for (auto& r : readers) r.join();
+
+    EXPECT_EQ(errors.load(), 0);
+    EXPECT_LE(maxRetired, 8u);
+    ht.insert(99999999, 1);  // читателей нет: всё убранное освобождается
+    ht.remove(99999999);
+    EXPECT_LE(ht.getRetiredCount(), 1u);
+    EXPECT_EQ(ht.getSize(), liveKeys);
+}
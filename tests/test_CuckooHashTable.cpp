@@ -0,0 +1,146 @@
+// Copyright message
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include "../include/CuckooHashTable.hpp"
+
+// BASICS
+
+TEST(CuckooHashTableTest, InsertFindRemove) {
+    CuckooHashTable<int, std::string> ht(10);
+
+    EXPECT_TRUE(ht.insert(1, "one"));
+    EXPECT_TRUE(ht.insert(2, "two"));
+    EXPECT_TRUE(ht.insert(1, "uno"));
+
+    EXPECT_EQ(ht.getSize(), 2);
+    EXPECT_EQ(ht.find(1), "uno");
+    EXPECT_EQ(ht.find(3), "");
+    EXPECT_TRUE(ht.isPresent(2));
+    EXPECT_EQ(ht.find_ptr(3), nullptr);
+
+    EXPECT_TRUE(ht.remove(1));
+    EXPECT_FALSE(ht.remove(1));
+    EXPECT_FALSE(ht.isPresent(1));
+    EXPECT_EQ(ht.getSize(), 1);
+}
+
+TEST(CuckooHashTableTest, StringKeysAndViewLookup) {
+    CuckooHashTable<std::string, int> ht(4);
+    for (int i = 0; i < 200; i++)
+        ht.insert("key" + std::to_string(i), i);
+
+    EXPECT_EQ(ht.find(std::string_view("key150")), 150);
+    EXPECT_TRUE(ht.isPresent("key0"));
+    EXPECT_TRUE(ht.remove("key0"));
+    EXPECT_FALSE(ht.isPresent("key0"));
+}
+
+// дробные и отрицательные ключи хешируются по битам, +0 и -0 — один ключ
+TEST(CuckooHashTableTest, FloatingKeys) {
+    CuckooHashTable<double, int> ht(4);
+    for (int i = 0; i < 400; i++)
+        ht.insert((i - 200) * 0.25, i);
+
+    EXPECT_EQ(ht.getSize(), 400);
+    for (int i = 0; i < 400; i++)
+        ASSERT_EQ(ht.find((i - 200) * 0.25), i);
+    EXPECT_FALSE(ht.isPresent(0.125));
+
+    EXPECT_TRUE(ht.isPresent(-0.0));
+    EXPECT_EQ(ht.find(-0.0), ht.find(0.0));
+}
+
+TEST(CuckooHashTableTest, CleanLeavesUsableTable) {
+    CuckooHashTable<int, int> ht(100);
+    for (int i = 0; i < 50; i++)
+        ht.insert(i, i);
+
+    ht.clean();
+    EXPECT_EQ(ht.getSize(), 0);
+    EXPECT_FALSE(ht.isPresent(1));
+
+    ht.insert(5, 50);
+    EXPECT_EQ(ht.find(5), 50);
+}
+
+
+// GROWTH AND DISPLACEMENT
+
+TEST(CuckooHashTableTest, MatchesReferenceUnderChurn) {
+    CuckooHashTable<int, int> ht(8);
+    std::unordered_map<int, int> reference;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> keys(0, 20000);
+
+    for (int step = 0; step < 100000; step++) {
+        int key = keys(rng);
+        if (rng() % 3 == 0) {
+            EXPECT_EQ(ht.remove(key), reference.erase(key) == 1);
+        } else {
+            ht.insert(key, step);
+            reference[key] = step;
+        }
+    }
+
+    EXPECT_EQ(ht.getSize(), reference.size());
+    for (const auto& [key, value] : reference)
+        ASSERT_EQ(ht.find(key), value);
+}
+
+TEST(CuckooHashTableTest, ReachesHighLoadBeforeGrowing) {
+    CuckooHashTable<int, int> ht(1024);
+    ht.setMaxLoadFactor(0.95f);
+    size_t capacity = ht.getCapacity();
+
+    for (int i = 0; i < 900; i++)
+        ht.insert(i, i);
+
+    EXPECT_EQ(ht.getCapacity(), capacity);
+    EXPECT_GT(ht.getLoadFactor(), 0.85f);
+    EXPECT_THROW(ht.setMaxLoadFactor(0.0f), std::invalid_argument);
+}
+
+TEST(CuckooHashTableTest, CopyIsIndependent) {
+    CuckooHashTable<std::string, std::string> ht(8);
+    for (int i = 0; i < 100; i++)
+        ht.insert(std::to_string(i), "v" + std::to_string(i));
+
+    CuckooHashTable<std::string, std::string> copy(ht);
+    ht.remove("5");
+    EXPECT_EQ(copy.find("5"), "v5");
+
+    CuckooHashTable<std::string, std::string> assigned(1);
+    assigned = copy;
+    EXPECT_EQ(assigned.getSize(), 100);
+    EXPECT_EQ(assigned.find("99"), "v99");
+}
+
+
+// SERIALIZATION
+
+TEST(CuckooHashTableTest, SaveAndLoad) {
+    CuckooHashTable<int, int> ht(64);
+    for (int i = 0; i < 300; i++)
+        ht.insert(i, i * 3);
+
+    ht.saveBinary("test_cuckoo.bin");
+    ht.saveText("test_cuckoo.txt");
+
+    CuckooHashTable<int, int> fromBinary(1);
+    fromBinary.loadBinary("test_cuckoo.bin");
+    CuckooHashTable<int, int> fromText(1);
+    fromText.loadText("test_cuckoo.txt");
+
+    EXPECT_EQ(fromBinary.getSize(), 300);
+    EXPECT_EQ(fromText.getSize(), 300);
+    for (int i = 0; i < 300; i++) {
+        ASSERT_EQ(fromBinary.find(i), i * 3);
+        ASSERT_EQ(fromText.find(i), i * 3);
+    }
+
+    std::remove("test_cuckoo.bin");
+    std::remove("test_cuckoo.txt");
+}
@@ -0,0 +1,98 @@
+// Copyright message
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "../include/FixedHashTableOA.hpp"
+
+// COMPILE-TIME TABLES
+
+constexpr FixedHashTableOA<std::string_view, int, 4> kStatusCodes = {
+    {"ok", 200}, {"created", 201}, {"not found", 404}, {"teapot", 418}};
+
+static_assert(kStatusCodes.getSize() == 4);
+static_assert(kStatusCodes.find("teapot") == 418);
+static_assert(kStatusCodes.find("missing") == 0);
+static_assert(!kStatusCodes.isPresent("OK"));
+static_assert(kStatusCodes.getCapacity() == 8);
+
+constexpr FixedHashTableOA<int, int, 64> makeSquares() {
+    FixedHashTableOA<int, int, 64> table;
+    for (int i = 0; i < 64; i++) {
+        table.insert(i * 1000, i * i);
+    }
+    return table;
+}
+
+constexpr auto kSquares = makeSquares();
+static_assert(kSquares.find(63000) == 3969);
+static_assert(kSquares.getMaxProbe() < kSquares.getCapacity());
+
+// дробные и отрицательные ключи хешируются по битам (приведение
+// -2.5 к uint64_t в constexpr не скомпилировалось бы)
+constexpr FixedHashTableOA<double, int, 5> kDoubles = {
+    {1.1, 1}, {1.9, 2}, {-2.5, 3}, {0.0, 4}, {1e300, 5}};
+static_assert(kDoubles.find(1.1) == 1);
+static_assert(kDoubles.find(1.9) == 2);
+static_assert(kDoubles.find(-2.5) == 3);
+static_assert(kDoubles.find(-0.0) == 4);
+static_assert(kDoubles.find(1e300) == 5);
+static_assert(!kDoubles.isPresent(1.5));
+
+TEST(FixedHashTableOATest, ConstexprTableAtRuntime) {
+    std::string key = "not found";
+    EXPECT_EQ(kStatusCodes.find(key), 404);
+    EXPECT_NE(kStatusCodes.find_ptr("ok"), nullptr);
+    EXPECT_EQ(kStatusCodes.find_ptr("nope"), nullptr);
+
+    for (int i = 0; i < 64; i++)
+        EXPECT_EQ(kSquares.find(i * 1000), i * i);
+    EXPECT_FALSE(kSquares.isPresent(1));
+}
+
+
+// RUNTIME USE
+
+TEST(FixedHashTableOATest, InsertStopsAtN) {
+    FixedHashTableOA<int, int, 3> ht;
+    EXPECT_TRUE(ht.insert(1, 10));
+    EXPECT_TRUE(ht.insert(2, 20));
+    EXPECT_TRUE(ht.insert(3, 30));
+    EXPECT_FALSE(ht.insert(4, 40));
+    // замена значения существующего ключа работает и у полной таблицы
+    EXPECT_TRUE(ht.insert(2, 22));
+
+    EXPECT_EQ(ht.getSize(), 3);
+    EXPECT_EQ(ht.find(2), 22);
+    EXPECT_FALSE(ht.isPresent(4));
+
+    EXPECT_THROW((FixedHashTableOA<int, int, 1>{{1, 1}, {2, 2}}),
+        std::length_error);
+}
+
+TEST(FixedHashTableOATest, RemoveMatchesReference) {
+    FixedHashTableOA<int, int, 200> ht;
+    std::unordered_map<int, int> reference;
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<int> keys(0, 400);
+
+    for (int step = 0; step < 20000; step++) {
+        int key = keys(rng);
+        if (rng() % 2) {
+            EXPECT_EQ(ht.remove(key), reference.erase(key) == 1);
+        } else if (reference.size() < 200 || reference.count(key)) {
+            EXPECT_TRUE(ht.insert(key, step));
+            reference[key] = step;
+        }
+    }
+
+    EXPECT_EQ(ht.getSize(), reference.size());
+    for (int key = 0; key <= 400; key++) {
+        auto it = reference.find(key);
+        ASSERT_EQ(ht.isPresent(key), it != reference.end());
+        if (it != reference.end()) {
+            ASSERT_EQ(ht.find(key), it->second);
+        }
+    }
+}
@@ -1,7 +1,14 @@
 // Copyright message
 #include <gtest/gtest.h>
 #include <gmpxx.h>
+#include <algorithm>
+#include <cstdio>
+#include <random>
 #include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 #include "../include/HashTableChains.hpp"
 
 // Используем int для ключа и значения, т.к. int конвертируется в mpz_class.
@@ -132,3 +139,529 @@ TEST(HashTableTest, DeepCopyAndAssignment) {
     // h3 должна остаться нетронутой
     EXPECT_TRUE(h3.isPresent(10));
 }
+
+// 8. Фильтр Блума перед таблицей: промахи отсекаются, ложных промахов нет
+TEST(HashTableTest, BloomFilterKeepsAnswersExact) {
+    IntHashTable ht(64);
+    for (int i = 0; i < 100; i++) ht.insert(i, i * 2);
+
+    ht.enableBloomFilter(200);
+    ASSERT_NE(ht.getBloomFilter(), nullptr);
+    EXPECT_EQ(ht.getBloomFilter()->getAdded(), 100);
+
+    for (int i = 100; i < 500; i++) ht.insert(i, i * 2);
+    for (int i = 0; i < 500; i++) {
+        ASSERT_TRUE(ht.isPresent(i));
+        ASSERT_EQ(ht.find(i), i * 2);
+    }
+    for (int i = 500; i < 1500; i++) ASSERT_FALSE(ht.isPresent(i));
+
+    // ключей стало больше вдвое против расчёта — фильтр пересобран
+    EXPECT_GE(ht.getBloomFilter()->getExpected(), 400);
+
+    // удалённые ключи не находятся, фильтр перестраивается по таблице
+    for (int i = 0; i < 300; i++) ht.remove(i);
+    EXPECT_LE(ht.getBloomFilter()->getRemoved() * 4,
+        ht.getBloomFilter()->getAdded());
+    for (int i = 0; i < 500; i++) ASSERT_EQ(ht.isPresent(i), i >= 300);
+
+    IntHashTable copy = ht;
+    EXPECT_NE(copy.getBloomFilter(), nullptr);
+    EXPECT_TRUE(copy.isPresent(450));
+
+    ht.disableBloomFilter();
+    EXPECT_EQ(ht.getBloomFilter(), nullptr);
+    EXPECT_TRUE(ht.isPresent(450));
+}
+
+// 9. Хеширование без GMP: арифметика по модулю 2^61 - 1 совпадает с mpz
+TEST(HashTableTest, Mersenne61ArithmeticMatchesGmp) {
+    std::mt19937_64 rng(11);
+    mpz_class m = hashing::kMersenne61;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t x = rng();
+        uint64_t a = hashing::reduce61(rng());
+        uint64_t b = hashing::reduce61(rng());
+
+        mpz_class expectedReduce = mpz_class(x) % m;
+        mpz_class expectedMul = (mpz_class(a) * mpz_class(b)) % m;
+        ASSERT_EQ(hashing::reduce61(x), expectedReduce.get_ui());
+        ASSERT_EQ(hashing::mulMod61(a, b), expectedMul.get_ui());
+    }
+    EXPECT_EQ(hashing::reduce61(hashing::kMersenne61), 0);
+}
+
+// 10. Индексы в пределах ёмкости и равномерны; нецелые ключи — через GMP
+TEST(HashTableTest, NativeHashingSpreadsKeys) {
+    IntHashTable ht(97);
+    std::vector<int> perBucket(97, 0);
+    for (int key = -5000; key < 5000; key++) {
+        int index = ht.hashing(key);
+        ASSERT_GE(index, 0);
+        ASSERT_LT(index, 97);
+        perBucket[index]++;
+    }
+    // в среднем ~103 ключа на корзину
+    EXPECT_LT(*std::max_element(perBucket.begin(), perBucket.end()), 200);
+
+    HashTable<double, int> doubles(16);
+    doubles.insert(1.5, 15);
+    doubles.insert(2.25, 22);
+    EXPECT_EQ(doubles.find(1.5), 15);
+    EXPECT_EQ(doubles.find(2.25), 22);
+    EXPECT_FALSE(doubles.isPresent(1.75));
+}
+
+// 11. Быстрый старт: простые из таблицы, поведение таблицы прежнее
+TEST(HashTableTest, FastSetupUsesPrecomputedPrimes) {
+    for (uint64_t prime : kHashTablePrimes) {
+        mpz_class p = static_cast<unsigned long>(prime);
+        ASSERT_NE(mpz_probab_prime_p(p.get_mpz_t(), 25), 0);
+    }
+
+    HashTable<int, int> ht(64, HashSetup::Fast);
+    for (int i = 0; i < 500; i++) ht.insert(i, i + 1);
+    for (int i = 0; i < 500; i++) ASSERT_EQ(ht.find(i), i + 1);
+    ht.remove(7);
+    EXPECT_FALSE(ht.isPresent(7));
+
+    ht.saveBinary("test_chains_fast.bin");
+    HashTable<int, int> loaded(1, HashSetup::Fast);
+    loaded.loadBinary("test_chains_fast.bin");
+    EXPECT_EQ(loaded.find(499), 500);
+    EXPECT_FALSE(loaded.isPresent(7));
+    std::remove("test_chains_fast.bin");
+
+    // с GmpHash нецелые ключи идут через GMP с p из таблицы
+    HashTable<double, int, GmpHash> doubles(8, HashSetup::Fast);
+    doubles.insert(0.5, 5);
+    EXPECT_EQ(doubles.find(0.5), 5);
+}
+
+// 12. remove возвращает удалённое значение; цепочка остаётся целой
+TEST(HashTableTest, RemoveReturnsValueAndKeepsChain) {
+    HashTable<int, std::string> ht(1);  // все ключи в одной корзине
+    ht.setMaxLoadFactor(100.0f);         // и таблица не растёт
+    for (int i = 0; i < 5; i++) ht.insert(i, "v" + std::to_string(i));
+
+    EXPECT_EQ(ht.remove(2), "v2");  // середина цепочки
+    EXPECT_EQ(ht.remove(0), "v0");  // голова
+    EXPECT_EQ(ht.remove(4), "v4");  // хвост
+    EXPECT_EQ(ht.remove(4), std::nullopt);
+
+    EXPECT_TRUE(ht.isPresent(1));
+    EXPECT_TRUE(ht.isPresent(3));
+    ht.insert(4, "again");
+    EXPECT_EQ(ht.find(4), "again");
+
+    ht.clean();
+    EXPECT_EQ(ht.remove(1), std::nullopt);
+}
+
+// 13. Рост с постепенным переносом: ключи видны на любом шаге переноса
+TEST(HashTableTest, GrowsIncrementally) {
+    IntHashTable ht(4, HashSetup::Fast);
+    bool sawRehashing = false;
+    for (int i = 0; i < 5000; i++) {
+        ht.insert(i, i * 3);
+        sawRehashing |= ht.isRehashing();
+        if (i % 97 == 0) {
+            for (int j = 0; j <= i; j += 13) ASSERT_EQ(ht.find(j), j * 3);
+        }
+    }
+    EXPECT_TRUE(sawRehashing);
+    EXPECT_EQ(ht.getSize(), 5000u);
+    EXPECT_LE(ht.getLoadFactor(), ht.getMaxLoadFactor());
+
+    // удаление, копия и сохранение посреди переноса
+    while (!ht.isRehashing()) ht.insert(ht.getSize() * 7 + 100000, 1);
+    EXPECT_EQ(ht.remove(10), 30);
+    EXPECT_FALSE(ht.isPresent(10));
+    ht.insert(10, 11);  // дубликат в старой корзине не появляется
+
+    IntHashTable copy(ht);
+    ht.saveBinary("test_chains_grow.bin");
+    IntHashTable loaded(1, HashSetup::Fast);
+    loaded.loadBinary("test_chains_grow.bin");
+    std::remove("test_chains_grow.bin");
+
+    for (int i = 0; i < 5000; i++) {
+        int expected = i == 10 ? 11 : i * 3;
+        ASSERT_EQ(ht.find(i), expected);
+        ASSERT_EQ(copy.find(i), expected);
+        ASSERT_EQ(loaded.find(i), expected);
+    }
+    EXPECT_EQ(copy.getSize(), ht.getSize());
+    EXPECT_EQ(loaded.getSize(), ht.getSize());
+}
+
+// 14. reserve и shrink_to_fit перестраивают таблицу сразу
+TEST(HashTableTest, ReserveAndShrinkToFit) {
+    IntHashTable ht(5, HashSetup::Fast);
+    ht.reserve(1000);
+    int reserved = ht.getCapacity();
+    EXPECT_GE(reserved * ht.getMaxLoadFactor(), 1000.0f);
+
+    for (int i = 0; i < 1000; i++) ht.insert(i, i);
+    EXPECT_EQ(ht.getCapacity(), reserved);  // без роста
+    EXPECT_FALSE(ht.isRehashing());
+
+    ht.reserve(10);  // меньше текущей — ничего не меняет
+    EXPECT_EQ(ht.getCapacity(), reserved);
+
+    for (int i = 0; i < 990; i++) ht.remove(i);
+    ht.shrink_to_fit();
+    EXPECT_LT(ht.getCapacity(), 20);
+    EXPECT_FALSE(ht.isRehashing());
+    for (int i = 990; i < 1000; i++) EXPECT_EQ(ht.find(i), i);
+    EXPECT_FALSE(ht.isPresent(5));
+
+    EXPECT_THROW(ht.setMaxLoadFactor(0.0f), std::invalid_argument);
+}
+
+// 15. Встроенные ячейки корзины и цепочка переполнения
+TEST(HashTableTest, InlineSlotsWithOverflow) {
+    static_assert(sizeof(Bucket<int, int>) == 64);
+    static_assert(alignof(Bucket<int, int>) == 64);
+    constexpr int kSlots = Bucket<int, int>::kInlineSlots;
+    EXPECT_EQ(kSlots, 6);
+
+    IntHashTable ht(1, HashSetup::Fast);  // одна корзина
+    ht.setMaxLoadFactor(100.0f);
+    for (int i = 0; i < 10; i++) ht.insert(i, i * 10);
+
+    // удаление из встроенных ячеек подтягивает пару из переполнения
+    EXPECT_EQ(ht.remove(0), 0);
+    EXPECT_EQ(ht.remove(kSlots - 1), (kSlots - 1) * 10);
+    EXPECT_EQ(ht.remove(9), 90);  // из переполнения
+    for (int i = 0; i < 10; i++) {
+        bool removed = i == 0 || i == kSlots - 1 || i == 9;
+        EXPECT_EQ(ht.isPresent(i), !removed) << i;
+        if (!removed) {
+            EXPECT_EQ(ht.find(i), i * 10);
+        }
+    }
+
+    // рост переносит и встроенные пары, и узлы переполнения
+    ht.setMaxLoadFactor(1.0f);
+    for (int i = 10; i < 200; i++) ht.insert(i, i * 10);
+    IntHashTable copy(ht);
+    for (int i = 1; i < 200; i++) {
+        if (i == kSlots - 1 || i == 9) continue;
+        ASSERT_EQ(ht.find(i), i * 10);
+        ASSERT_EQ(copy.find(i), i * 10);
+    }
+    EXPECT_EQ(copy.getSize(), 197u);
+}
+
+// 16. Узлы переполнения из пула таблицы или из обычной кучи
+TEST(HashTableTest, NodeAllocatorPolicy) {
+    IntHashTable pooled(1, HashSetup::Fast);
+    pooled.setMaxLoadFactor(1000.0f);  // всё в переполнении одной корзины
+    ASSERT_NE(pooled.getNodePool(), nullptr);
+
+    int inlineSlots = Bucket<int, int>::kInlineSlots;
+    for (int i = 0; i < 500; i++) pooled.insert(i, i);
+    EXPECT_EQ(pooled.getNodePool()->getNodesInUse(), 500u - inlineSlots);
+
+    // удалённые узлы идут на следующие вставки, новых плит нет
+    size_t slabs = pooled.getNodePool()->getSlabCount();
+    for (int round = 0; round < 5; round++) {
+        for (int i = 0; i < 250; i++) pooled.remove(i);
+        for (int i = 0; i < 250; i++) pooled.insert(i, i + round);
+    }
+    EXPECT_EQ(pooled.getNodePool()->getSlabCount(), slabs);
+    EXPECT_EQ(pooled.find(10), 14);
+
+    IntHashTable copy(pooled);  // у копии свой пул
+    EXPECT_NE(copy.getNodePool(), pooled.getNodePool());
+    pooled.clean();
+    EXPECT_EQ(pooled.getNodePool()->getSlabCount(), 0u);
+    EXPECT_EQ(copy.find(499), 499);
+
+    HashTable<int, std::string, hashing::Hash<int>,
+        std::allocator<Pair<int, std::string>>> heap(1, HashSetup::Fast);
+    EXPECT_EQ(heap.getNodePool(), nullptr);
+    for (int i = 0; i < 100; i++) heap.insert(i, std::to_string(i));
+    EXPECT_EQ(heap.remove(50), "50");
+    EXPECT_EQ(heap.find(99), "99");
+}
+
+// 17. Ключи без целочисленного хеша хранят полный хеш; при росте он
+// не пересчитывается, а равные хеши не подменяют сравнение ключей
+TEST(HashTableTest, CachedFullHash) {
+    static_assert(!kBucketCachesHash<int>);
+    static_assert(!kBucketCachesHash<double>);
+    static_assert(kBucketCachesHash<double, GmpHash>);
+    static_assert(kBucketCachesHash<std::string>);
+
+    // дробная часть в GMP-хеш не попадает: у i + 0.25 и i + 0.5
+    // одинаковый хеш, но это разные ключи
+    HashTable<double, int, GmpHash> ht(1, HashSetup::Fast);
+    for (int i = 0; i < 300; i++) {
+        ht.insert(i + 0.25, i);
+        ht.insert(i + 0.5, -i);
+    }
+    EXPECT_EQ(ht.getSize(), 600u);
+    EXPECT_FALSE(ht.isPresent(7.75));
+
+    for (int i = 0; i < 300; i += 3) {
+        EXPECT_EQ(ht.remove(i + 0.25), i);
+    }
+    HashTable<double, int, GmpHash> copy(ht);
+    for (int i = 0; i < 300; i++) {
+        bool removed = i % 3 == 0;
+        ASSERT_EQ(ht.isPresent(i + 0.25), !removed) << i;
+        ASSERT_EQ(copy.find(i + 0.5), -i) << i;
+    }
+
+    // после копии хеши те же: рост копии переносит пары правильно
+    for (int i = 300; i < 2000; i++) copy.insert(i + 0.5, -i);
+    for (int i = 0; i < 2000; i++) {
+        ASSERT_EQ(copy.find(i + 0.5), -i) << i;
+    }
+}
+
+// 18. Строки, кортежи и свои структуры как ключи; свой Hasher
+struct Point {
+    int x;
+    int y;
+    bool operator==(const Point& other) const {
+        return x == other.x && y == other.y;
+    }
+};
+
+// все ключи в одну корзину: поиск держится только на сравнении ключей
+struct ConstantHash {
+    uint64_t operator()(const std::string&) const {
+        return 42;
+    }
+};
+
+TEST(HashTableTest, GenericKeysAndCustomHasher) {
+    HashTable<std::string, int> words(4, HashSetup::Fast);
+    for (int i = 0; i < 1000; i++) words.insert("w" + std::to_string(i), i);
+    EXPECT_EQ(words.find("w999"), 999);
+    EXPECT_EQ(words.remove("w10"), 10);
+    EXPECT_FALSE(words.isPresent("w10"));
+    EXPECT_FALSE(words.isPresent("w1000"));
+
+    HashTable<std::tuple<int, std::string>, int> tuples(4, HashSetup::Fast);
+    tuples.insert({1, "a"}, 1);
+    tuples.insert({1, "b"}, 2);
+    tuples.insert({2, "a"}, 3);
+    EXPECT_EQ(tuples.find({1, "b"}), 2);
+    EXPECT_EQ(tuples.find({2, "a"}), 3);
+    EXPECT_FALSE(tuples.isPresent({2, "b"}));
+
+    HashTable<Point, int> points(4, HashSetup::Fast);
+    for (int i = 0; i < 100; i++) points.insert({i, -i}, i);
+    EXPECT_EQ(points.find({7, -7}), 7);
+    EXPECT_FALSE(points.isPresent({-7, 7}));
+    hashing::Hash<std::pair<int, int>> pairHash;
+    EXPECT_NE(pairHash({1, 2}), pairHash({2, 1}));
+
+    HashTable<std::string, int, ConstantHash> same(8, HashSetup::Fast);
+    for (int i = 0; i < 50; i++) same.insert(std::to_string(i), i);
+    HashTable<std::string, int, ConstantHash> copy(same);
+    for (int i = 0; i < 50; i++) ASSERT_EQ(copy.find(std::to_string(i)), i);
+    EXPECT_EQ(same.remove("25"), 25);
+    EXPECT_EQ(same.getSize(), 49u);
+}
+
+// 19. Перемещение и swap за O(1): пары, пул и параметры хеша переходят
+// целиком; перемещённая таблица пуста и снова принимает вставки
+TEST(HashTableTest, MoveAndSwap) {
+    static_assert(std::is_nothrow_move_constructible_v<IntHashTable>);
+    static_assert(std::is_nothrow_move_assignable_v<IntHashTable>);
+
+    IntHashTable ht(4, HashSetup::Fast);
+    for (int i = 0; i < 1000; i++) ht.insert(i, i * 2);
+    const NodePool* pool = ht.getNodePool();
+    int capacity = ht.getCapacity();
+
+    IntHashTable moved(std::move(ht));
+    EXPECT_EQ(moved.getSize(), 1000u);
+    EXPECT_EQ(moved.getCapacity(), capacity);
+    EXPECT_EQ(moved.getNodePool(), pool);
+    EXPECT_EQ(moved.find(999), 1998);
+
+    EXPECT_EQ(ht.getSize(), 0u);
+    EXPECT_FALSE(ht.isPresent(1));
+    IntHashTable emptyCopy(ht);
+    EXPECT_EQ(emptyCopy.getSize(), 0u);
+    for (int i = 0; i < 100; i++) ht.insert(i, -i);
+    EXPECT_EQ(ht.find(50), -50);
+    EXPECT_NE(ht.getNodePool(), pool);
+
+    ht = std::move(moved);
+    EXPECT_EQ(ht.getSize(), 1000u);
+    EXPECT_EQ(ht.find(50), 100);
+
+    IntHashTable other(8, HashSetup::Fast);
+    other.insert(-1, 1);
+    swap(ht, other);
+    EXPECT_EQ(ht.getSize(), 1u);
+    EXPECT_EQ(other.find(999), 1998);
+
+    // строковые ключи и перемещённая таблица после clean()
+    HashTable<std::string, std::string> words(4, HashSetup::Fast);
+    words.insert("a", "1");
+    words.clean();
+    words.insert("b", "2");
+    HashTable<std::string, std::string> taken = std::move(words);
+    EXPECT_EQ(taken.find("b"), "2");
+    words.insert("c", "3");
+    EXPECT_EQ(words.find("c"), "3");
+
+    std::vector<IntHashTable> tables;
+    for (int i = 0; i < 20; i++) {
+        tables.emplace_back(4, HashSetup::Fast);
+        tables.back().insert(i, i);
+    }
+    for (int i = 0; i < 20; i++) ASSERT_EQ(tables[i].find(i), i);
+}
+
+// 20. Ключи, равные по модулю 2^61 - 1 (-1 и 7 для int64_t, 0 и
+// 2^61 - 1 для uint64_t), не склеиваются: хотя бы в одной из таблиц
+// со случайными параметрами они попадают в разные корзины
+TEST(HashTableTest, KeysEqualModMersenneDoNotCollide) {
+    const uint64_t mersenne = (uint64_t{1} << 61) - 1;
+    bool signedSplit = false;
+    bool unsignedSplit = false;
+    for (int i = 0; i < 8; i++) {
+        HashTable<int64_t, int> signedKeys(65537, HashSetup::Fast);
+        signedSplit |= signedKeys.hashing(-1) != signedKeys.hashing(7);
+        HashTable<uint64_t, int> unsignedKeys(65537, HashSetup::Fast);
+        unsignedSplit |=
+            unsignedKeys.hashing(0) != unsignedKeys.hashing(mersenne);
+    }
+    EXPECT_TRUE(signedSplit);
+    EXPECT_TRUE(unsignedSplit);
+
+    HashTable<int64_t, int> ht(16);
+    ht.insert(-1, 1);
+    ht.insert(7, 7);
+    EXPECT_EQ(ht.find(-1), 1);
+    EXPECT_EQ(ht.find(7), 7);
+}
+
+// 21. Ключи mpz_class со стандартным Hasher и с GmpHash, в том числе
+// с фильтром Блума: его хеш тоже берётся из полного хеша таблицы
+TEST(HashTableTest, MpzKeys) {
+    const mpz_class big("123456789012345678901234567890");
+    HashTable<mpz_class, int> ht(8, HashSetup::Fast);
+    ht.enableBloomFilter(100);
+    for (int i = 0; i < 100; i++) ht.insert(big * i, i);
+    EXPECT_EQ(ht.getSize(), 100u);
+    EXPECT_EQ(ht.find(big * 42), 42);
+    EXPECT_FALSE(ht.isPresent(big * 100));
+    EXPECT_FALSE(ht.isPresent(-big));
+    EXPECT_EQ(ht.remove(big * 7), 7);
+    EXPECT_FALSE(ht.isPresent(big * 7));
+
+    HashTable<mpz_class, int, GmpHash> gmp(8);
+    gmp.enableBloomFilter(100);
+    for (int i = 0; i < 100; i++) gmp.insert(big + i, i);
+    EXPECT_EQ(gmp.find(big + 99), 99);
+    EXPECT_FALSE(gmp.isPresent(big - 1));
+    EXPECT_EQ(gmp.remove(big), 0);
+    EXPECT_EQ(gmp.getSize(), 99u);
+}
+
+// 22. Ключ без std::hash и с дырой в представлении (hashing::Hash для
+// него не компилируется): рост, копия и фильтр Блума хешируют только
+// через переданный Hasher
+struct Tagged {
+    char tag;
+    int64_t id;
+    bool operator==(const Tagged& other) const {
+        return tag == other.tag && id == other.id;
+    }
+};
+
+struct TaggedHash {
+    uint64_t operator()(const Tagged& key) const {
+        return hashing::mix(static_cast<uint64_t>(key.id),
+            static_cast<unsigned char>(key.tag));
+    }
+};
+
+TEST(HashTableTest, CustomHasherOnlyKey) {
+    static_assert(!hashing::kHasStdHash<Tagged>);
+    static_assert(!std::has_unique_object_representations_v<Tagged>);
+
+    HashTable<Tagged, int, TaggedHash> ht(4, HashSetup::Fast);
+    ht.enableBloomFilter(16);
+    for (int i = 0; i < 1000; i++) ht.insert({'a', i}, i);
+    for (int i = 0; i < 1000; i++) ht.insert({'b', i}, -i);
+    EXPECT_EQ(ht.getSize(), 2000u);
+    EXPECT_EQ(ht.find({'a', 500}), 500);
+    EXPECT_EQ(ht.find({'b', 500}), -500);
+    EXPECT_FALSE(ht.isPresent({'c', 500}));
+
+    HashTable<Tagged, int, TaggedHash> copy(ht);
+    EXPECT_EQ(copy.remove({'b', 999}), -999);
+    EXPECT_FALSE(copy.isPresent({'b', 999}));
+    EXPECT_TRUE(ht.isPresent({'b', 999}));
+}
+
+// 23. Перестройка фильтра Блума посреди переноса корзин не доводит
+// перенос до конца: фильтр строится по старым и новым корзинам
+TEST(HashTableTest, BloomRebuildKeepsMigrationIncremental) {
+    using Words = HashTable<std::string, int>;
+    auto word = [](int i) { return "w" + std::to_string(i); };
+
+    // размер, при котором начинается первое удвоение после 2000 ключей
+    size_t growAt = 0;
+    Words probe(4, HashSetup::Fast);
+    for (int i = 0; growAt == 0; i++) {
+        bool wasRehashing = probe.isRehashing();
+        probe.insert(word(i), i);
+        if (i >= 2000 && !wasRehashing && probe.isRehashing())
+            growAt = probe.getSize();
+    }
+
+    // фильтр переполнится (ключей вдвое больше расчётного) через
+    // несколько вставок после начала удвоения
+    Words ht(4, HashSetup::Fast);
+    ht.enableBloomFilter(growAt / 2 + 2);
+    const BlockedBloomFilter* first = ht.getBloomFilter();
+    int n = static_cast<int>(growAt) + 5;
+    for (int i = 0; i < n; i++) ht.insert(word(i), i);
+
+    EXPECT_NE(ht.getBloomFilter(), first);
+    EXPECT_TRUE(ht.isRehashing());
+    for (int i = 0; i < n; i++) ASSERT_TRUE(ht.isPresent(word(i)));
+    EXPECT_FALSE(ht.isPresent(word(n)));
+}
+
+// 24. reserve() и shrink_to_fit() без корзин (после clean() или
+// перемещения) запоминают ёмкость, и вставки её не меняют
+TEST(HashTableTest, ReserveWithoutBuckets) {
+    IntHashTable ht(4, HashSetup::Fast);
+    for (int i = 0; i < 100; i++) ht.insert(i, i);
+    ht.clean();
+    ht.reserve(5000);
+    int capacity = ht.getCapacity();
+    EXPECT_GE(capacity, 5000 / ht.getMaxLoadFactor());
+    for (int i = 0; i < 5000; i++) {
+        ht.insert(i, -i);
+        ASSERT_FALSE(ht.isRehashing());
+    }
+    EXPECT_EQ(ht.getCapacity(), capacity);
+    EXPECT_EQ(ht.find(4999), -4999);
+
+    IntHashTable moved(std::move(ht));
+    ht.reserve(1000);
+    capacity = ht.getCapacity();
+    for (int i = 0; i < 1000; i++) ht.insert(i, i);
+    EXPECT_EQ(ht.getCapacity(), capacity);
+    EXPECT_FALSE(ht.isRehashing());
+
+    ht.clean();
+    ht.shrink_to_fit();
+    EXPECT_LT(ht.getCapacity(), capacity);
+    ht.insert(1, 1);
+    EXPECT_EQ(ht.find(1), 1);
+}
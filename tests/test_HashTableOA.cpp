@@ -1,6 +1,16 @@
 // Copyright message
 #include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
 #include <string>
+#include <random>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 #include "../include/HashTableOA.hpp"
 
 // BASICS
@@ -193,6 +203,47 @@ TEST(HashTableOATest, AssignmentOperator) {
     EXPECT_FALSE(ht2.isPresent(3));
 }
 
+TEST(HashTableOATest, MoveAndSwap) {
+    static_assert(std::is_nothrow_move_constructible_v<
+        HashTableOA<int, std::string>>);
+    static_assert(std::is_nothrow_move_assignable_v<
+        HashTableOA<int, std::string>>);
+
+    HashTableOA<int, std::string> ht1(10);
+    for (int i = 0; i < 100; i++) ht1.insert(i, std::to_string(i));
+    size_t capacity = ht1.getCapacity();
+
+    HashTableOA<int, std::string> ht2(std::move(ht1));
+    EXPECT_EQ(ht2.getSize(), 100u);
+    EXPECT_EQ(ht2.getCapacity(), capacity);
+    EXPECT_EQ(ht2.find(42), "42");
+
+    // перемещённая таблица пуста и снова принимает вставки
+    EXPECT_EQ(ht1.getSize(), 0u);
+    EXPECT_FALSE(ht1.isPresent(42));
+    ht1.insert(7, "seven");
+    EXPECT_EQ(ht1.find(7), "seven");
+
+    ht1 = std::move(ht2);
+    EXPECT_EQ(ht1.getSize(), 100u);
+    EXPECT_FALSE(ht1.isPresent(-1));
+    EXPECT_EQ(ht1.find(99), "99");
+
+    HashTableOA<int, std::string> other(4);
+    other.insert(-1, "minus");
+    swap(ht1, other);
+    EXPECT_EQ(ht1.getSize(), 1u);
+    EXPECT_EQ(other.find(99), "99");
+
+    // вектор таблиц переносит их при росте, а не копирует
+    std::vector<HashTableOA<int, std::string>> tables;
+    for (int i = 0; i < 20; i++) {
+        tables.emplace_back(4);
+        tables.back().insert(i, std::to_string(i));
+    }
+    for (int i = 0; i < 20; i++) ASSERT_EQ(tables[i].find(i), std::to_string(i));
+}
+
 
 // STRING KEYS
 
@@ -225,18 +276,19 @@ TEST(HashTableOATest, RemoveAndReuse) {
 
 // EDGE CASES
 
-TEST(HashTableOATest, InsertUntilFull) {
+TEST(HashTableOATest, InsertPastCapacityGrows) {
     HashTableOA<int, int> ht(5);
 
-    for (int i = 0; i < 5; i++)
+    // раньше шестая вставка падала с "table is full", теперь таблица растёт
+    for (int i = 0; i < 100; i++)
         EXPECT_TRUE(ht.insert(i, i * 10));
 
-    // таблица полностью заполнена
-    testing::internal::CaptureStderr();
-    EXPECT_FALSE(ht.insert(100, 200));
-    std::string output = testing::internal::GetCapturedStderr();
+    EXPECT_EQ(ht.getSize(), 100);
+    EXPECT_GT(ht.getCapacity(), 100);
+    EXPECT_LE(ht.getLoadFactor(), ht.getMaxLoadFactor());
 
-    EXPECT_NE(output.find("Error: table is full"), std::string::npos);
+    for (int i = 0; i < 100; i++)
+        EXPECT_EQ(ht.find(i), i * 10);
 }
 
 TEST(HashTableOATest, LoadFactorCorrect) {
@@ -260,3 +312,848 @@ TEST(HashTableOATest, getLoadFactorReturnsZero) {
 
     EXPECT_FLOAT_EQ(ht.getLoadFactor(), 0.0f);
 }
+
+
+// GROWTH AND INCREMENTAL REHASH
+
+TEST(HashTableOATest, ZeroCapacityGrowsOnInsert) {
+    HashTableOA<int, int> ht(0);
+
+    EXPECT_TRUE(ht.insert(42, 1));
+    EXPECT_TRUE(ht.isPresent(42));
+    EXPECT_GT(ht.getCapacity(), 0);
+}
+
+TEST(HashTableOATest, LookupsDuringIncrementalRehash) {
+    HashTableOA<int, int> ht(64);
+
+    // 48 = 0.75 * 64, следующая вставка запускает рост
+    for (int i = 0; i < 48; i++)
+        ht.insert(i, i);
+    EXPECT_FALSE(ht.isRehashing());
+
+    ht.insert(1000, 1000);
+    EXPECT_TRUE(ht.isRehashing());
+    EXPECT_EQ(ht.getCapacity(), 128);
+
+    // часть ключей ещё в старой таблице
+    EXPECT_EQ(ht.find(47), 47);
+    EXPECT_TRUE(ht.isPresent(0));
+
+    // обновление ключа, который ещё не переехал
+    EXPECT_TRUE(ht.insert(46, -46));
+    EXPECT_TRUE(ht.remove(45));
+    EXPECT_EQ(ht.getSize(), 48);
+
+    for (int i = 0; i < 20 && ht.isRehashing(); i++)
+        ht.find(0);
+    EXPECT_FALSE(ht.isRehashing());
+
+    EXPECT_EQ(ht.find(46), -46);
+    EXPECT_FALSE(ht.isPresent(45));
+    EXPECT_EQ(ht.find(1000), 1000);
+    for (int i = 0; i < 45; i++)
+        EXPECT_EQ(ht.find(i), i);
+}
+
+TEST(HashTableOATest, CopyDuringRehash) {
+    HashTableOA<int, int> ht(64);
+
+    for (int i = 0; i < 49; i++)
+        ht.insert(i, i * 2);
+    EXPECT_TRUE(ht.isRehashing());
+
+    HashTableOA<int, int> copy(ht);
+    EXPECT_FALSE(copy.isRehashing());
+    EXPECT_EQ(copy.getSize(), 49);
+    for (int i = 0; i < 49; i++)
+        EXPECT_EQ(copy.find(i), i * 2);
+}
+
+TEST(HashTableOATest, TombstonesDoNotFillTable) {
+    HashTableOA<int, int> ht(16);
+
+    // постоянный размер, но много удалений: надгробия вычищаются ростом
+    for (int round = 0; round < 1000; round++) {
+        EXPECT_TRUE(ht.insert(round, round));
+        EXPECT_TRUE(ht.remove(round));
+    }
+
+    EXPECT_EQ(ht.getSize(), 0);
+    EXPECT_EQ(ht.getCapacity(), 16);
+    EXPECT_TRUE(ht.insert(7, 7));
+    EXPECT_EQ(ht.find(7), 7);
+}
+
+TEST(HashTableOATest, ReinsertAfterRemoveDoesNotDuplicate) {
+    HashTableOA<int, int> ht(5);
+
+    ht.insert(1, 10);
+    ht.insert(6, 60);
+    ht.remove(1);
+
+    // надгробие перед ключом не должно приводить к дубликату
+    ht.insert(6, 61);
+    ht.remove(6);
+
+    EXPECT_FALSE(ht.isPresent(6));
+    EXPECT_EQ(ht.getSize(), 0);
+}
+
+TEST(HashTableOATest, SetMaxLoadFactorValidates) {
+    HashTableOA<int, int> ht(10);
+
+    EXPECT_THROW(ht.setMaxLoadFactor(0.0f), std::invalid_argument);
+    EXPECT_THROW(ht.setMaxLoadFactor(1.5f), std::invalid_argument);
+
+    ht.setMaxLoadFactor(0.5f);
+    for (int i = 0; i < 5; i++)
+        ht.insert(i, i);
+    EXPECT_EQ(ht.getCapacity(), 10);
+
+    ht.insert(5, 5);
+    EXPECT_EQ(ht.getCapacity(), 20);
+}
+
+TEST(HashTableOATest, RemovedKeyStaysRemovedAfterMigration) {
+    HashTableOA<int, int> ht(64);
+
+    for (int i = 0; i < 49; i++)
+        ht.insert(i, i);
+    EXPECT_TRUE(ht.isRehashing());
+
+    // ключи уже переехали в новую таблицу, старая копия не должна
+    // "воскреснуть" после удаления
+    while (ht.isRehashing())
+        ht.find(0);
+    for (int i = 0; i < 49; i++)
+        EXPECT_TRUE(ht.remove(i));
+
+    for (int i = 0; i < 49; i++)
+        EXPECT_FALSE(ht.isPresent(i));
+    EXPECT_EQ(ht.getSize(), 0);
+}
+
+
+// CONTROL BYTES AND GROUP PROBING
+
+TEST(HashTableOATest, SmallCapacityWrapsAroundGroup) {
+    HashTableOA<int, int> ht(3);
+    ht.setMaxLoadFactor(1.0f);
+
+    // при ёмкости меньше группы байты хвоста дублируют начало массива
+    EXPECT_TRUE(ht.insert(10, 1));
+    EXPECT_TRUE(ht.insert(20, 2));
+    EXPECT_TRUE(ht.insert(30, 3));
+    EXPECT_EQ(ht.getCapacity(), 3);
+
+    EXPECT_EQ(ht.find(10), 1);
+    EXPECT_EQ(ht.find(20), 2);
+    EXPECT_EQ(ht.find(30), 3);
+    EXPECT_FALSE(ht.isPresent(40));
+
+    EXPECT_TRUE(ht.remove(20));
+    EXPECT_FALSE(ht.isPresent(20));
+    EXPECT_TRUE(ht.insert(40, 4));
+    EXPECT_EQ(ht.find(40), 4);
+    EXPECT_EQ(ht.getCapacity(), 3);
+}
+
+TEST(HashTableOATest, ManyKeysAcrossGroups) {
+    HashTableOA<std::string, int> ht(16);
+
+    for (int i = 0; i < 5000; i++)
+        ht.insert("key" + std::to_string(i), i);
+    for (int i = 0; i < 5000; i += 2)
+        EXPECT_TRUE(ht.remove("key" + std::to_string(i)));
+
+    EXPECT_EQ(ht.getSize(), 2500);
+    for (int i = 0; i < 5000; i++) {
+        if (i % 2 == 0) {
+            EXPECT_FALSE(ht.isPresent("key" + std::to_string(i)));
+        } else {
+            EXPECT_EQ(ht.find("key" + std::to_string(i)), i);
+        }
+    }
+}
+
+
+// ROBIN HOOD
+
+TEST(HashTableOATest, RobinHoodBasicOperations) {
+    HashTableOA<int, std::string> ht(10, ProbingPolicy::RobinHood);
+    EXPECT_EQ(ht.getProbingPolicy(), ProbingPolicy::RobinHood);
+
+    EXPECT_TRUE(ht.insert(1, "one"));
+    EXPECT_TRUE(ht.insert(11, "eleven"));
+    EXPECT_TRUE(ht.insert(21, "twenty one"));
+    EXPECT_TRUE(ht.insert(11, "ELEVEN"));
+
+    EXPECT_EQ(ht.getSize(), 3);
+    EXPECT_EQ(ht.find(11), "ELEVEN");
+
+    EXPECT_TRUE(ht.remove(1));
+    EXPECT_FALSE(ht.remove(1));
+    EXPECT_FALSE(ht.isPresent(1));
+    EXPECT_EQ(ht.find(21), "twenty one");
+    EXPECT_EQ(ht.find(11), "ELEVEN");
+}
+
+TEST(HashTableOATest, RobinHoodMatchesReferenceUnderChurn) {
+    HashTableOA<int, int> ht(64, ProbingPolicy::RobinHood);
+    ht.setMaxLoadFactor(0.9f);
+    std::unordered_map<int, int> reference;
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> keyDist(0, 300);
+    for (int step = 0; step < 20000; step++) {
+        int key = keyDist(rng);
+        if (rng() % 3 == 0) {
+            EXPECT_EQ(ht.remove(key), reference.erase(key) == 1);
+        } else {
+            ht.insert(key, step);
+            reference[key] = step;
+        }
+    }
+
+    EXPECT_EQ(ht.getSize(), reference.size());
+    for (int key = 0; key <= 300; key++) {
+        auto it = reference.find(key);
+        EXPECT_EQ(ht.isPresent(key), it != reference.end());
+        if (it != reference.end()) {
+            EXPECT_EQ(ht.find(key), it->second);
+        }
+    }
+}
+
+TEST(HashTableOATest, RobinHoodChurnKeepsCapacity) {
+    HashTableOA<int, int> ht(128, ProbingPolicy::RobinHood);
+
+    for (int i = 0; i < 64; i++)
+        ht.insert(i, i);
+
+    // без надгробий постоянная вставка/удаление не заставляет таблицу
+    // перестраиваться
+    for (int i = 64; i < 100000; i++) {
+        ht.remove(i - 64);
+        ht.insert(i, i);
+    }
+
+    EXPECT_EQ(ht.getSize(), 64);
+    EXPECT_EQ(ht.getCapacity(), 128);
+    EXPECT_FALSE(ht.isRehashing());
+    for (int i = 100000 - 64; i < 100000; i++)
+        EXPECT_EQ(ht.find(i), i);
+}
+
+TEST(HashTableOATest, RobinHoodGrowsAndCopies) {
+    HashTableOA<int, int> ht(4, ProbingPolicy::RobinHood);
+
+    for (int i = 0; i < 1000; i++)
+        ht.insert(i * 7, i);
+    for (int i = 0; i < 1000; i += 3)
+        ht.remove(i * 7);
+
+    HashTableOA<int, int> copy(ht);
+    EXPECT_EQ(copy.getProbingPolicy(), ProbingPolicy::RobinHood);
+    for (int i = 0; i < 1000; i++) {
+        EXPECT_EQ(copy.isPresent(i * 7), i % 3 != 0);
+        EXPECT_EQ(ht.isPresent(i * 7), i % 3 != 0);
+    }
+}
+
+
+// FAST HASH MODE
+
+TEST(HashTableOATest, FastModeRoundsCapacityToPowerOfTwo) {
+    HashTableOA<int, int> ht(100, HashMode::Fast);
+
+    EXPECT_EQ(ht.getHashMode(), HashMode::Fast);
+    EXPECT_EQ(ht.getCapacity(), 128);
+
+    for (int i = 0; i < 1000; i++)
+        ht.insert(i, -i);
+
+    EXPECT_EQ(ht.getCapacity(), 2048);
+    for (int i = 0; i < 1000; i++)
+        EXPECT_EQ(ht.find(i), -i);
+}
+
+TEST(HashTableOATest, FastModeMatchesReference) {
+    HashTableOA<int, int> ht(16, ProbingPolicy::RobinHood, HashMode::Fast);
+    std::unordered_map<int, int> reference;
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> keyDist(-500, 500);
+    for (int step = 0; step < 20000; step++) {
+        int key = keyDist(rng);
+        if (rng() % 2 == 0) {
+            EXPECT_EQ(ht.remove(key), reference.erase(key) == 1);
+        } else {
+            ht.insert(key, step);
+            reference[key] = step;
+        }
+    }
+
+    EXPECT_EQ(ht.getSize(), reference.size());
+    for (auto& [key, value] : reference)
+        EXPECT_EQ(ht.find(key), value);
+}
+
+TEST(HashTableOATest, FastModeCopyKeepsSeed) {
+    HashTableOA<std::string, int> ht(8, HashMode::Fast);
+    ht.insert("alpha", 1);
+    ht.insert("beta", 2);
+
+    HashTableOA<std::string, int> copy(8, HashMode::Fast);
+    copy = ht;
+
+    EXPECT_EQ(copy.find("alpha"), 1);
+    EXPECT_EQ(copy.find("beta"), 2);
+    copy.insert("gamma", 3);
+    EXPECT_EQ(copy.find("gamma"), 3);
+    EXPECT_FALSE(ht.isPresent("gamma"));
+}
+
+
+// STRING HASHING
+
+TEST(HashTableOATest, HashBytesCoversAllLengthBranches) {
+    std::string text(300, 'x');
+    for (size_t i = 0; i < text.size(); i++)
+        text[i] = static_cast<char>('a' + i % 26);
+
+    // каждая длина от 0 до 300 даёт свой хеш, и он не зависит от того,
+    // std::string это или std::string_view
+    std::unordered_map<uint64_t, size_t> seen;
+    for (size_t len = 0; len <= text.size(); len++) {
+        std::string prefix = text.substr(0, len);
+        uint64_t h = hashing::hashBytes(prefix);
+        EXPECT_EQ(h, hashing::hashBytes(std::string_view(text).substr(0, len)));
+        EXPECT_TRUE(seen.emplace(h, len).second) << "collision at " << len;
+    }
+
+    EXPECT_NE(hashing::hashBytes("abc", 1), hashing::hashBytes("abc", 2));
+}
+
+TEST(HashTableOATest, LongStringKeysBothModes) {
+    for (HashMode mode : {HashMode::Universal, HashMode::Fast}) {
+        HashTableOA<std::string, int> ht(16, mode);
+
+        for (int i = 0; i < 2000; i++) {
+            std::string url = "https://example.com/path/" + std::to_string(i);
+            url.append(static_cast<size_t>(i % 180), 'q');
+            EXPECT_TRUE(ht.insert(url, i));
+        }
+
+        EXPECT_EQ(ht.getSize(), 2000);
+        for (int i = 0; i < 2000; i++) {
+            std::string url = "https://example.com/path/" + std::to_string(i);
+            url.append(static_cast<size_t>(i % 180), 'q');
+            EXPECT_EQ(ht.find(url), i);
+        }
+    }
+}
+
+TEST(HashTableOATest, StringViewKeys) {
+    HashTableOA<std::string_view, int> ht(8, HashMode::Fast);
+
+    ht.insert("first", 1);
+    ht.insert("second", 2);
+
+    EXPECT_EQ(ht.find("first"), 1);
+    EXPECT_TRUE(ht.remove("second"));
+    EXPECT_FALSE(ht.isPresent("second"));
+}
+
+
+// NON-COPYING AND HETEROGENEOUS LOOKUP
+
+TEST(HashTableOATest, FindPtrDistinguishesMissFromDefault) {
+    HashTableOA<int, int> ht(10);
+    ht.insert(1, 0);
+
+    const int* stored = ht.find_ptr(1);
+    ASSERT_NE(stored, nullptr);
+    EXPECT_EQ(*stored, 0);
+    EXPECT_EQ(ht.find_ptr(2), nullptr);
+
+    // значение можно менять на месте
+    *ht.find_ptr(1) = 42;
+    EXPECT_EQ(ht.find(1), 42);
+}
+
+TEST(HashTableOATest, TryGetReturnsReference) {
+    HashTableOA<int, std::string> ht(10);
+    ht.insert(7, "seven");
+
+    auto hit = ht.try_get(7);
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->get(), "seven");
+    hit->get() += "!";
+    EXPECT_EQ(ht.find(7), "seven!");
+
+    const auto& constTable = ht;
+    auto constHit = constTable.try_get(7);
+    ASSERT_TRUE(constHit.has_value());
+    EXPECT_EQ(&constHit->get(), constTable.find_ptr(7));
+    EXPECT_FALSE(constTable.try_get(8).has_value());
+}
+
+TEST(HashTableOATest, StringViewLookupOnStringKeys) {
+    HashTableOA<std::string, int> ht(16);
+    ht.insert("GET /index.html", 200);
+    ht.insert("GET /missing", 404);
+
+    std::string request = "GET /index.html HTTP/1.1";
+    std::string_view path = std::string_view(request).substr(0, 15);
+
+    EXPECT_TRUE(ht.isPresent(path));
+    EXPECT_EQ(ht.find(path), 200);
+    ASSERT_NE(ht.find_ptr(path), nullptr);
+    EXPECT_EQ(*ht.find_ptr(path), 200);
+    EXPECT_FALSE(ht.isPresent(std::string_view(request)));
+
+    EXPECT_TRUE(ht.remove(std::string_view("GET /missing")));
+    EXPECT_FALSE(ht.isPresent("GET /missing"));
+}
+
+TEST(HashTableOATest, FindPtrDuringRehash) {
+    HashTableOA<int, int> ht(64);
+    for (int i = 0; i < 49; i++)
+        ht.insert(i, i + 1);
+    EXPECT_TRUE(ht.isRehashing());
+
+    for (int i = 0; i < 49; i++) {
+        const int* value = ht.find_ptr(i);
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(*value, i + 1);
+    }
+}
+
+
+// EMPLACE / TRY_EMPLACE / INSERT_OR_ASSIGN
+
+namespace {
+
+// считает копии, чтобы проверить, что вставка обходится перемещением
+struct CopyCounter {
+    static int copies;
+    std::vector<int> payload;
+
+    CopyCounter() = default;
+    explicit CopyCounter(size_t n) : payload(n, 1) {}
+    CopyCounter(const CopyCounter& other) : payload(other.payload) {
+        copies++;
+    }
+    CopyCounter(CopyCounter&&) noexcept = default;
+    CopyCounter& operator=(const CopyCounter& other) {
+        payload = other.payload;
+        copies++;
+        return *this;
+    }
+    CopyCounter& operator=(CopyCounter&&) noexcept = default;
+};
+
+int CopyCounter::copies = 0;
+
+}  // namespace
+
+TEST(HashTableOATest, TryEmplaceConstructsInPlace) {
+    HashTableOA<int, CopyCounter> ht(16);
+    CopyCounter::copies = 0;
+
+    auto [value, inserted] = ht.try_emplace(1, 100);
+    EXPECT_TRUE(inserted);
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(value->payload.size(), 100);
+
+    // второй вызов не трогает существующее значение
+    auto again = ht.try_emplace(1, 5);
+    EXPECT_FALSE(again.second);
+    EXPECT_EQ(again.first, value);
+    EXPECT_EQ(again.first->payload.size(), 100);
+
+    EXPECT_EQ(CopyCounter::copies, 0);
+}
+
+TEST(HashTableOATest, InsertOrAssignMovesValue) {
+    HashTableOA<int, CopyCounter> ht(16);
+    CopyCounter::copies = 0;
+
+    auto first = ht.insert_or_assign(3, CopyCounter(10));
+    EXPECT_TRUE(first.second);
+
+    auto second = ht.insert_or_assign(3, CopyCounter(20));
+    EXPECT_FALSE(second.second);
+    EXPECT_EQ(second.first->payload.size(), 20);
+    EXPECT_EQ(ht.getSize(), 1);
+
+    EXPECT_EQ(CopyCounter::copies, 0);
+
+    // обычный insert по-прежнему копирует
+    CopyCounter big(30);
+    ht.insert(4, big);
+    EXPECT_EQ(CopyCounter::copies, 1);
+}
+
+TEST(HashTableOATest, MoveOnlyValues) {
+    HashTableOA<std::string, std::unique_ptr<int>> ht(4);
+
+    for (int i = 0; i < 100; i++) {
+        auto result = ht.try_emplace("k" + std::to_string(i),
+                                     std::make_unique<int>(i));
+        EXPECT_TRUE(result.second);
+    }
+
+    ht.insert_or_assign("k5", std::make_unique<int>(500));
+
+    EXPECT_EQ(ht.getSize(), 100);
+    EXPECT_EQ(**ht.find_ptr("k5"), 500);
+    EXPECT_EQ(**ht.find_ptr("k99"), 99);
+    EXPECT_TRUE(ht.remove("k0"));
+}
+
+TEST(HashTableOATest, EmplaceWithHeterogeneousKey) {
+    HashTableOA<std::string, int> ht(8);
+
+    EXPECT_TRUE(ht.emplace("alpha", 1).second);
+    EXPECT_TRUE(ht.emplace(std::string_view("beta"), 2).second);
+    EXPECT_FALSE(ht.emplace("alpha", 3).second);
+
+    EXPECT_EQ(ht.find("alpha"), 1);
+    EXPECT_EQ(ht.find("beta"), 2);
+}
+
+TEST(HashTableOATest, RobinHoodEmplaceReturnsOwnSlot) {
+    HashTableOA<int, int> ht(32, ProbingPolicy::RobinHood);
+
+    for (int i = 0; i < 500; i++) {
+        auto [value, inserted] = ht.try_emplace(i * 3, i);
+        EXPECT_TRUE(inserted);
+        EXPECT_EQ(*value, i);
+    }
+    for (int i = 0; i < 500; i++)
+        EXPECT_EQ(ht.find(i * 3), i);
+}
+
+
+// BATCHED LOOKUP
+
+TEST(HashTableOATest, FindBatchMatchesScalarFind) {
+    HashTableOA<int, int> ht(16, HashMode::Fast);
+    for (int i = 0; i < 1000; i += 2)
+        ht.insert(i, i * 10);
+
+    // 37 ключей — неполная последняя группа
+    std::vector<int> keys;
+    for (int i = 0; i < 37; i++)
+        keys.push_back(i * 3);
+    std::vector<int*> out(keys.size());
+
+    size_t found = ht.find_batch(keys, out);
+
+    size_t expected = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+        if (keys[i] % 2 == 0) {
+            ASSERT_NE(out[i], nullptr);
+            EXPECT_EQ(*out[i], keys[i] * 10);
+            expected++;
+        } else {
+            EXPECT_EQ(out[i], nullptr);
+        }
+    }
+    EXPECT_EQ(found, expected);
+
+    // через указатели можно менять значения
+    *out[0] = -1;
+    EXPECT_EQ(ht.find(0), -1);
+}
+
+TEST(HashTableOATest, FindBatchDuringRehashAndStrings) {
+    HashTableOA<std::string, int> ht(64);
+    std::vector<std::string> keys;
+    for (int i = 0; i < 49; i++) {
+        keys.push_back("key" + std::to_string(i));
+        ht.insert(keys.back(), i);
+    }
+    keys.push_back("missing");
+    EXPECT_TRUE(ht.isRehashing());
+
+    const auto& constTable = ht;
+    std::vector<const int*> out(keys.size());
+    EXPECT_EQ(constTable.find_batch(keys, out), 49);
+    for (int i = 0; i < 49; i++)
+        EXPECT_EQ(*out[i], i);
+    EXPECT_EQ(out[49], nullptr);
+}
+
+TEST(HashTableOATest, FindBatchRejectsShortOutput) {
+    HashTableOA<int, int> ht(16);
+    std::vector<int> keys = {1, 2, 3};
+    std::vector<int*> out(2);
+
+    EXPECT_THROW(ht.find_batch(keys, out), std::invalid_argument);
+}
+
+
+// SNAPSHOT
+
+TEST(HashTableOATest, SnapshotRoundTripLinear) {
+    HashTableOA<int, double> ht(64);
+    for (int i = 0; i < 1000; i++)
+        ht.insert(i, i * 0.5);
+    for (int i = 0; i < 1000; i += 3)
+        ht.remove(i);
+
+    ht.saveSnapshot("test_htoa_snapshot.bin");
+
+    HashTableOA<int, double> loaded(16);
+    loaded.loadSnapshot("test_htoa_snapshot.bin");
+
+    EXPECT_EQ(loaded.getSize(), ht.getSize());
+    EXPECT_EQ(loaded.getCapacity(), ht.getCapacity());
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_EQ(loaded.isPresent(i), i % 3 != 0);
+        if (i % 3) {
+            ASSERT_EQ(loaded.find(i), i * 0.5);
+        }
+    }
+
+    // изменения идут в копии страниц и файл не трогают
+    for (int i = 1000; i < 5000; i++)
+        loaded.insert(i, 1.0);
+    EXPECT_TRUE(loaded.remove(1));
+    EXPECT_EQ(loaded.getSize(), ht.getSize() + 3999);
+
+    HashTableOA<int, double> again(16);
+    again.loadSnapshot("test_htoa_snapshot.bin", false);
+    EXPECT_EQ(again.getSize(), ht.getSize());
+    EXPECT_TRUE(again.isPresent(1));
+    EXPECT_FALSE(again.isPresent(1000));
+
+    std::remove("test_htoa_snapshot.bin");
+}
+
+TEST(HashTableOATest, SnapshotKeepsPolicyModeAndSeed) {
+    HashTableOA<uint64_t, uint64_t> ht(16, ProbingPolicy::RobinHood,
+        HashMode::Fast);
+    for (uint64_t i = 0; i < 3000; i++)
+        ht.insert(i * 7919, i);
+
+    ht.saveSnapshot("test_htoa_snapshot.bin");
+
+    HashTableOA<uint64_t, uint64_t> loaded(16);
+    loaded.loadSnapshot("test_htoa_snapshot.bin");
+
+    EXPECT_EQ(loaded.getProbingPolicy(), ProbingPolicy::RobinHood);
+    EXPECT_EQ(loaded.getHashMode(), HashMode::Fast);
+    for (uint64_t i = 0; i < 3000; i++)
+        ASSERT_EQ(loaded.find(i * 7919), i);
+
+    for (uint64_t i = 0; i < 3000; i += 2)
+        ASSERT_TRUE(loaded.remove(i * 7919));
+    EXPECT_EQ(loaded.getSize(), 1500);
+    EXPECT_FALSE(loaded.isPresent(0));
+    EXPECT_EQ(loaded.find(7919), 1);
+
+    std::remove("test_htoa_snapshot.bin");
+}
+
+// у перемещённой и очищенной таблицы массивов нет: снимок пустой,
+// после загрузки таблица снова принимает вставки
+TEST(HashTableOATest, SnapshotOfEmptyTable) {
+    HashTableOA<int, int> ht(64);
+    ht.insert(1, 1);
+    HashTableOA<int, int> taken(std::move(ht));
+    ht.saveSnapshot("test_htoa_snapshot.bin");
+
+    HashTableOA<int, int> loaded(16);
+    loaded.insert(5, 5);
+    loaded.loadSnapshot("test_htoa_snapshot.bin");
+    EXPECT_EQ(loaded.getSize(), 0);
+    EXPECT_FALSE(loaded.isPresent(5));
+    loaded.insert(2, 20);
+    EXPECT_EQ(loaded.find(2), 20);
+
+    HashTableOA<int, int> cleaned(64, ProbingPolicy::RobinHood,
+        HashMode::Fast);
+    for (int i = 0; i < 30; i++)
+        cleaned.insert(i, i);
+    cleaned.clean();
+    cleaned.saveSnapshot("test_htoa_snapshot.bin");
+
+    HashTableOA<int, int> again(16);
+    again.loadSnapshot("test_htoa_snapshot.bin");
+    EXPECT_EQ(again.getSize(), 0);
+    EXPECT_EQ(again.getProbingPolicy(), ProbingPolicy::RobinHood);
+    for (int i = 0; i < 30; i++)
+        again.insert(i, -i);
+    EXPECT_EQ(again.find(29), -29);
+
+    std::remove("test_htoa_snapshot.bin");
+}
+
+TEST(HashTableOATest, SnapshotRejectsCorruptedOrForeignFiles) {
+    HashTableOA<int, int> ht(100);
+    for (int i = 0; i < 50; i++)
+        ht.insert(i, i);
+    ht.saveSnapshot("test_htoa_snapshot.bin");
+
+    HashTableOA<int64_t, int> wrongType(16);
+    EXPECT_THROW(wrongType.loadSnapshot("test_htoa_snapshot.bin"),
+        std::runtime_error);
+
+    {
+        std::fstream file("test_htoa_snapshot.bin",
+            std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-1, std::ios::end);
+        char c = 0x5A;
+        file.write(&c, 1);
+    }
+
+    // при ошибке таблица остаётся прежней
+    HashTableOA<int, int> loaded(16);
+    loaded.insert(7, 70);
+    EXPECT_THROW(loaded.loadSnapshot("test_htoa_snapshot.bin"),
+        std::runtime_error);
+    EXPECT_EQ(loaded.getSize(), 1);
+    EXPECT_EQ(loaded.find(7), 70);
+
+    EXPECT_THROW(loaded.loadSnapshot("no_such_snapshot.bin"),
+        std::runtime_error);
+
+    std::remove("test_htoa_snapshot.bin");
+}
+
+// Правка одного поля заголовка: соль ловит только контрольная сумма,
+// невозможные значения остальных полей — сама проверка заголовка,
+// даже при verify = false.
+TEST(HashTableOATest, SnapshotRejectsPatchedHeader) {
+    HashTableOA<uint64_t, uint64_t> ht(64, ProbingPolicy::Linear,
+        HashMode::Fast);
+    for (uint64_t i = 0; i < 20; i++)
+        ht.insert(i, i);
+    ht.saveSnapshot("test_htoa_snapshot.bin");
+
+    std::string original;
+    {
+        std::ifstream file("test_htoa_snapshot.bin", std::ios::binary);
+        original.assign(std::istreambuf_iterator<char>(file), {});
+    }
+    auto loadPatched = [&](size_t offset, const void* bytes, size_t length,
+                           bool verify) {
+        std::string patched = original;
+        std::memcpy(&patched[offset], bytes, length);
+        std::ofstream("test_htoa_snapshot.bin", std::ios::binary)
+            << patched;
+        HashTableOA<uint64_t, uint64_t> loaded(16);
+        loaded.loadSnapshot("test_htoa_snapshot.bin", verify);
+    };
+
+    // смещения полей SnapshotHeader
+    const size_t policyAt = 24, modeAt = 25, loadFactorAt = 28;
+    const size_t capacityAt = 32, deletedAt = 48, seedAt = 72;
+
+    uint8_t seedByte = original[seedAt] ^ 0x01;
+    EXPECT_THROW(loadPatched(seedAt, &seedByte, 1, true),
+        std::runtime_error);
+    EXPECT_NO_THROW(loadPatched(seedAt, &seedByte, 1, false));
+
+    uint8_t bad = 7;
+    EXPECT_THROW(loadPatched(policyAt, &bad, 1, false), std::runtime_error);
+    EXPECT_THROW(loadPatched(modeAt, &bad, 1, false), std::runtime_error);
+
+    uint64_t capacity = 63;
+    EXPECT_THROW(loadPatched(capacityAt, &capacity, sizeof(capacity), false),
+        std::runtime_error);
+    uint64_t deleted = 60;
+    EXPECT_THROW(loadPatched(deletedAt, &deleted, sizeof(deleted), false),
+        std::runtime_error);
+    for (float factor : {0.0f, -0.5f, 1.5f}) {
+        EXPECT_THROW(loadPatched(loadFactorAt, &factor, sizeof(factor),
+            false), std::runtime_error);
+    }
+
+    std::remove("test_htoa_snapshot.bin");
+}
+
+
+// TELEMETRY
+
+TEST(HashTableOATest, StatsReportTombstonesAndDisplacement) {
+    HashTableOA<int, int> ht(64);
+    for (int i = 0; i < 40; i++)
+        ht.insert(i, i);
+    for (int i = 0; i < 40; i += 2)
+        ht.remove(i);
+
+    HashTableOAStats stats = ht.getStats();
+    EXPECT_EQ(stats.size, 20);
+    EXPECT_EQ(stats.capacity, ht.getCapacity());
+    EXPECT_EQ(stats.tombstones, 20);
+    EXPECT_FLOAT_EQ(stats.tombstoneRatio, 20.0f / stats.capacity);
+    EXPECT_FLOAT_EQ(stats.loadFactor, ht.getLoadFactor());
+    EXPECT_LE(stats.averageDisplacement, stats.maxDisplacement);
+
+    uint64_t keys = 0;
+    for (uint64_t count : stats.displacementGroups) keys += count;
+    EXPECT_EQ(keys, 20);
+
+    // без Telemetry счётчики не ведутся
+    ht.find(1);
+    EXPECT_EQ(ht.getStats().probeHistogram[0], 0);
+}
+
+TEST(HashTableOATest, TelemetryCountsProbes) {
+    HashTableOA<int, int, true> ht(1024);
+    for (int i = 0; i < 100; i++)
+        ht.insert(i, i);
+    ht.resetStats();
+
+    for (int i = 0; i < 200; i++)
+        ht.find(i);
+
+    HashTableOAStats stats = ht.getStats();
+    uint64_t probes = 0;
+    for (uint64_t count : stats.probeHistogram) probes += count;
+    EXPECT_EQ(probes, 200);
+    EXPECT_GT(stats.probeHistogram[0], 0);
+    EXPECT_EQ(stats.failedInserts, 0);
+
+    // копия начинает счёт с нуля
+    HashTableOA<int, int, true> copy(ht);
+    EXPECT_EQ(copy.getStats().probeHistogram[0], 0);
+    EXPECT_TRUE(copy.isPresent(99));
+}
+
+TEST(HashTableOATest, PurgeTombstonesKeepsCapacity) {
+    HashTableOA<int, int> ht(256);
+    for (int i = 0; i < 150; i++)
+        ht.insert(i, i);
+    size_t capacity = ht.getCapacity();
+    for (int i = 0; i < 150; i += 3)
+        ht.remove(i);
+    EXPECT_EQ(ht.getStats().tombstones, 50);
+
+    ht.purgeTombstones();
+    EXPECT_EQ(ht.getStats().tombstones, 0);
+    EXPECT_EQ(ht.getCapacity(), capacity);
+    EXPECT_EQ(ht.getSize(), 100);
+    for (int i = 0; i < 150; i++)
+        ASSERT_EQ(ht.isPresent(i), i % 3 != 0);
+}
+
+TEST(HashTableOATest, TombstonePurgeRatioTriggersRehash) {
+    HashTableOA<int, int> ht(256);
+    EXPECT_THROW(ht.setTombstonePurgeRatio(1.5f), std::invalid_argument);
+    ht.setTombstonePurgeRatio(0.1f);
+
+    for (int i = 0; i < 150; i++)
+        ht.insert(i, i);
+    for (int i = 0; i < 150; i++) {
+        ht.remove(i);
+        ASSERT_LE(ht.getStats().tombstoneRatio, 0.1f);
+    }
+    EXPECT_EQ(ht.getSize(), 0);
+}
@@ -0,0 +1,55 @@
+// Copyright message
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "../include/DL_List.hpp"
+#include "../include/NodePool.hpp"
+
+TEST(NodePoolTest, ReusesFreedNodes) {
+    NodePool pool;
+    void* first = pool.allocate(24, 8);
+    void* second = pool.allocate(24, 8);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(pool.getNodesInUse(), 2u);
+    EXPECT_EQ(pool.getSlabCount(), 1u);
+
+    pool.deallocate(first, 24, 8);
+    EXPECT_EQ(pool.allocate(24, 8), first);  // из списка свободных
+
+    // другой размер — мимо пула, в обычную кучу
+    void* other = pool.allocate(100, 8);
+    EXPECT_EQ(pool.getNodesInUse(), 2u);
+    pool.deallocate(other, 100, 8);
+
+    std::vector<void*> nodes;
+    for (int i = 0; i < 10000; i++) nodes.push_back(pool.allocate(24, 8));
+    EXPECT_GT(pool.getSlabCount(), 1u);
+
+    pool.release();  // все плиты разом
+    EXPECT_EQ(pool.getSlabCount(), 0u);
+    EXPECT_EQ(pool.getNodesInUse(), 0u);
+    EXPECT_NE(pool.allocate(24, 8), nullptr);
+}
+
+TEST(NodePoolTest, DLListWithPoolAllocator) {
+    NodePool pool;
+    using PooledList = DL_list<std::string, PoolAllocator<std::string>>;
+    PooledList list{PoolAllocator<std::string>(pool)};
+
+    for (int i = 0; i < 100; i++) list.addTail(std::to_string(i));
+    EXPECT_EQ(pool.getNodesInUse(), 100u);
+
+    list.removeByValue("50");
+    EXPECT_EQ(pool.getNodesInUse(), 99u);
+    list.addHead("head");
+    EXPECT_EQ(pool.getNodesInUse(), 100u);
+
+    PooledList copy = list;  // копия берёт узлы из того же пула
+    EXPECT_EQ(pool.getNodesInUse(), 200u);
+    EXPECT_EQ(copy.getHead()->value, "head");
+    EXPECT_EQ(copy.searchByValue("99"), 99);
+
+    copy.clear();
+    list.clear();
+    EXPECT_EQ(pool.getNodesInUse(), 0u);
+}
@@ -0,0 +1,118 @@
+// Copyright message
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/ShardedHashTableOA.hpp"
+
+// BASICS
+
+TEST(ShardedHashTableOATest, InsertFindRemove) {
+    ShardedHashTableOA<int, int> ht(100, 8);
+
+    EXPECT_EQ(ht.getShardCount(), 8);
+
+    EXPECT_TRUE(ht.insert(1, 10));
+    EXPECT_TRUE(ht.insert(2, 20));
+    EXPECT_TRUE(ht.insert(1, 11));
+
+    EXPECT_EQ(ht.getSize(), 2);
+    EXPECT_EQ(ht.find(1), 11);
+    EXPECT_EQ(ht.find(3), 0);
+    EXPECT_TRUE(ht.isPresent(2));
+
+    EXPECT_TRUE(ht.remove(2));
+    EXPECT_FALSE(ht.remove(2));
+    EXPECT_FALSE(ht.isPresent(2));
+    EXPECT_EQ(ht.getSize(), 1);
+}
+
+TEST(ShardedHashTableOATest, ShardCountRoundedToPowerOfTwo) {
+    ShardedHashTableOA<int, int> ht(100, 5);
+    EXPECT_EQ(ht.getShardCount(), 8);
+
+    ShardedHashTableOA<int, int> single(100, 0);
+    EXPECT_EQ(single.getShardCount(), 1);
+    single.insert(5, 50);
+    EXPECT_EQ(single.find(5), 50);
+}
+
+TEST(ShardedHashTableOATest, TryGetAndEmplace) {
+    ShardedHashTableOA<std::string, std::string> ht(16);
+
+    EXPECT_TRUE(ht.try_emplace("a", 3, 'x'));
+    EXPECT_FALSE(ht.try_emplace("a", 5, 'y'));
+    EXPECT_EQ(ht.find("a"), "xxx");
+
+    EXPECT_FALSE(ht.insert_or_assign("a", std::string("new")));
+    EXPECT_TRUE(ht.insert_or_assign("b", std::string("bee")));
+
+    auto hit = ht.try_get(std::string_view("b"));
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(*hit, "bee");
+    EXPECT_FALSE(ht.try_get("c").has_value());
+
+    ht.clean();
+    EXPECT_EQ(ht.getSize(), 0);
+}
+
+
+// CONCURRENCY
+
+TEST(ShardedHashTableOATest, ConcurrentInsertsFromManyThreads) {
+    ShardedHashTableOA<int, int> ht(16, 16);
+    const int threads = 8;
+    const int perThread = 5000;
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&ht, t] {
+            for (int i = 0; i < perThread; i++) {
+                int key = t * perThread + i;
+                ht.insert(key, key * 2);
+            }
+        });
+    }
+    for (auto& w : workers) w.join();
+
+    EXPECT_EQ(ht.getSize(), threads * perThread);
+    for (int key = 0; key < threads * perThread; key++)
+        ASSERT_EQ(ht.find(key), key * 2);
+}
+
+TEST(ShardedHashTableOATest, ReadersDuringGrowthAndRemoval) {
+    ShardedHashTableOA<int, int> ht(16, 4);
+    for (int key = 0; key < 1000; key++)
+        ht.insert(key, key);
+
+    // писатели растят таблицу и удаляют ключи вне 0..999, читатели
+    // всё это время должны видеть все постоянные ключи
+    std::atomic<bool> stop{false};
+    std::atomic<int> misses{0};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; t++) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                for (int key = 0; key < 1000; key++) {
+                    if (ht.find(key) != key) misses++;
+                }
+            }
+        });
+    }
+
+    std::thread writer([&] {
+        for (int key = 1000; key < 50000; key++) {
+            ht.insert(key, key);
+            if (key % 3 == 0) ht.remove(key);
+        }
+        stop.store(true);
+    });
+
+    writer.join();
+    for (auto& r : readers) r.join();
+
+    EXPECT_EQ(misses.load(), 0);
+    EXPECT_EQ(ht.getSize(), 1000 + (49000 - 49000 / 3));
+}
@@ -270,3 +270,27 @@ TEST(DLListTest, PrintFunctionality) {
     EXPECT_NE(outputBack.find("3"), std::string::npos);
     EXPECT_NE(outputBack.find("<->"), std::string::npos);
 }
+
+// удаление узла по указателю
+TEST(DLListTest, UnlinkNode) {
+    DL_list<int> list;
+    list.addTail(1);
+    list.addTail(2);
+    list.addTail(3);
+
+    list.unlink(list.getHead()->next);  // середина
+    EXPECT_EQ(list.getSize(), 2);
+    EXPECT_EQ(list.getHead()->next->value, 3);
+    EXPECT_EQ(list.getHead()->next->previous, list.getHead());
+
+    list.unlink(list.getHead());  // голова
+    EXPECT_EQ(list.getHead()->value, 3);
+    EXPECT_EQ(list.getHead()->previous, nullptr);
+
+    list.unlink(list.getHead());  // единственный
+    EXPECT_TRUE(list.empty());
+    EXPECT_EQ(list.getHead(), nullptr);
+
+    list.addTail(4);  // голова и хвост снова корректны
+    EXPECT_EQ(list.getHead()->value, 4);
+}